@@ -72,6 +72,18 @@ void Application::SetBackgroundColor(const glm::vec4& color) {
   renderer_->SetBackgroundColor(color);
 }
 
+void Application::SetLightingMode(LightingMode mode) {
+  renderer_->SetLightingMode(mode);
+}
+
+void Application::SetScreenOutlineMode(ScreenOutlineMode mode) {
+  renderer_->SetScreenOutlineMode(mode);
+}
+
+void Application::SetScreenOutlineStyle(const ScreenOutlineStyle& style) {
+  renderer_->SetScreenOutlineStyle(style);
+}
+
 void Application::InitializeGUI() {
   IMGUI_CHECKVERSION();
   ImGui::CreateContext();
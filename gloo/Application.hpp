@@ -27,6 +27,9 @@ class Application {
   virtual void SetupScene() = 0;
   std::unique_ptr<Scene> scene_;
   void SetBackgroundColor(const glm::vec4& color);
+  void SetLightingMode(LightingMode mode);
+  void SetScreenOutlineMode(ScreenOutlineMode mode);
+  void SetScreenOutlineStyle(const ScreenOutlineStyle& style);
 
  private:
   void InitializeGLFW();
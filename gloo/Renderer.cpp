@@ -1,6 +1,9 @@
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <tuple>
+#include <unordered_map>
 #include <glad/glad.h>
 #include <glm/gtx/string_cast.hpp>
 
@@ -9,6 +12,7 @@
 #include "utils.hpp"
 #include "gl_wrapper/BindGuard.hpp"
 #include "shaders/ShaderProgram.hpp"
+#include "components/MaterialComponent.hpp"
 #include "components/ShadingComponent.hpp"
 #include "components/CameraComponent.hpp"
 #include "debug/PrimitiveFactory.hpp"
@@ -21,7 +25,8 @@ const glm::mat4 kLightProjection =
 }  // namespace
 
 namespace GLOO {
-Renderer::Renderer(Application& application) : application_(application) {
+Renderer::Renderer(Application& application)
+    : gl_state_(GLStateCache::GetInstance()), application_(application) {
   UNUSED(application_);
   background_color_ = glm::vec4(0, 0, 0, 1.);
   // Reserve Space for Shadow Depth Texture
@@ -38,6 +43,44 @@ Renderer::Renderer(Application& application) : application_(application) {
   // to quad_ created below and then call quad_->GetVertexArray().Render().
   plain_texture_shader_ = make_unique<PlainTextureShader>();
   quad_ = PrimitiveFactory::CreateQuad();
+  light_block_buffer_ = make_unique<UniformBuffer<LightBlock>>();
+  camera_block_buffer_ = make_unique<UniformBuffer<CameraBlock>>();
+  material_block_buffer_ = make_unique<UniformBuffer<MaterialBlock>>();
+
+  // Screen space outline buffers, sized once they're used
+  TextureConfig screen_texture_config = {{GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE},
+                                         {GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE},
+                                         {GL_TEXTURE_MIN_FILTER, GL_NEAREST},
+                                         {GL_TEXTURE_MAG_FILTER, GL_NEAREST}};
+  normal_depth_tex_ = make_unique<Texture>(screen_texture_config);
+  screen_depth_tex_ = make_unique<Texture>(screen_texture_config);
+  normal_depth_buffer_ = make_unique<Framebuffer>();
+  normal_depth_buffer_->AssociateTexture(*normal_depth_tex_, GL_COLOR_ATTACHMENT0);
+  normal_depth_buffer_->AssociateTexture(*screen_depth_tex_, GL_DEPTH_ATTACHMENT);
+  normal_depth_shader_ = make_unique<NormalDepthShader>();
+  edge_detection_shader_ = make_unique<EdgeDetectionShader>();
+  for (int i = 0; i < 2; i++) {
+    seed_textures_[i] = make_unique<Texture>(screen_texture_config);
+    seed_buffers_[i] = make_unique<Framebuffer>();
+    seed_buffers_[i]->AssociateTexture(*seed_textures_[i], GL_COLOR_ATTACHMENT0);
+  }
+  jump_flood_shader_ = make_unique<JumpFloodShader>();
+  distance_outline_shader_ = make_unique<DistanceOutlineShader>();
+
+  // Deferred rendering G-buffer, also sized once it's used
+  low_color_tex_ = make_unique<Texture>(screen_texture_config);
+  high_color_tex_ = make_unique<Texture>(screen_texture_config);
+  material_tex_ = make_unique<Texture>(screen_texture_config);
+  g_buffer_ = make_unique<Framebuffer>();
+  g_buffer_->AssociateTexture(*normal_depth_tex_, GL_COLOR_ATTACHMENT0);
+  g_buffer_->AssociateTexture(*low_color_tex_, GL_COLOR_ATTACHMENT1);
+  g_buffer_->AssociateTexture(*high_color_tex_, GL_COLOR_ATTACHMENT2);
+  g_buffer_->AssociateTexture(*material_tex_, GL_COLOR_ATTACHMENT3);
+  g_buffer_->AssociateTexture(*screen_depth_tex_, GL_DEPTH_ATTACHMENT);
+  g_buffer_->SetDrawBuffers({GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2,
+                             GL_COLOR_ATTACHMENT3});
+  g_buffer_shader_ = make_unique<GBufferShader>();
+  deferred_lighting_shader_ = make_unique<DeferredLightingShader>();
 }
 
 void Renderer::SetRenderingOptions() const {
@@ -45,23 +88,36 @@ void Renderer::SetRenderingOptions() const {
                         background_color_.a));
 
   // Enable depth test.
-  GL_CHECK(glEnable(GL_DEPTH_TEST));
-  GL_CHECK(glDepthFunc(GL_LEQUAL));
+  gl_state_.SetDepthTest(true);
+  gl_state_.SetDepthFunc(GL_LEQUAL);
 
   // Make sure multisampling is turned on
   // TODO: Not turned on right now because the shaders themselves aren't anti-aliased
   // glEnable(GL_MULTISAMPLE);
 
   // Enable blending for multi-pass forward rendering.
-  GL_CHECK(glEnable(GL_BLEND));
-  GL_CHECK(glBlendFunc(GL_ONE, GL_ONE));
+  gl_state_.SetBlend(true);
+  gl_state_.SetBlendFunc(GL_ONE, GL_ONE);
 }
 
 void Renderer::SetBackgroundColor(const glm::vec4& color) { background_color_ = color; }
 
+void Renderer::SetLightingMode(LightingMode mode) { lighting_mode_ = mode; }
+
+void Renderer::SetScreenOutlineMode(ScreenOutlineMode mode) { screen_outline_mode_ = mode; }
+
+void Renderer::SetScreenOutlineStyle(const ScreenOutlineStyle& style) {
+  screen_outline_style_ = style;
+}
+
 void Renderer::Render(const Scene& scene) const {
+  // The GUI changes GL state behind the cache's back between frames
+  gl_state_.Invalidate();
   SetRenderingOptions();
   RenderScene(scene);
+  // Index buffer bindings are stored in the bound vertex array, so don't leave one bound for
+  // buffer updates outside of rendering.
+  gl_state_.BindVertexArray(0);
 }
 
 void Renderer::RecursiveRetrieve(const SceneNode& node,
@@ -86,9 +142,41 @@ Renderer::RenderingInfo Renderer::RetrieveRenderingInfo(
   const SceneNode& root = scene.GetRootNode();
   // Efficient implementation without redundant matrix multiplications.
   RecursiveRetrieve(root, info, glm::mat4(1.0f));
+  SortRenderQueue(info);
   return info;
 }
 
+void Renderer::SortRenderQueue(RenderingInfo& info) {
+  // Group draws by shader, then material, then vertex array, so state changes scale with the
+  // number of distinct states. Groups keep the order their state first appears in the scene graph,
+  // so e.g. outlines are still drawn after the meshes they outline, which matters where their
+  // depths are equal.
+  std::unordered_map<const void*, size_t> first_seen;
+  auto rank = [&first_seen](const void* state) {
+    return first_seen.emplace(state, first_seen.size()).first->second;
+  };
+  std::vector<std::tuple<size_t, size_t, size_t, size_t>> keys;
+  keys.reserve(info.size());
+  for (size_t i = 0; i < info.size(); i++) {
+    SceneNode& node = *info[i].first->GetNodePtr();
+    auto shading_ptr = node.GetComponentPtr<ShadingComponent>();
+    auto material_ptr = node.GetComponentPtr<MaterialComponent>();
+    size_t shader_rank = rank(shading_ptr == nullptr ? nullptr : shading_ptr->GetShaderPtr());
+    size_t material_rank =
+        rank(material_ptr == nullptr ? nullptr : &material_ptr->GetMaterial());
+    size_t vertex_array_rank = rank(&info[i].first->GetVertexObjectPtr()->GetVertexArray());
+    keys.emplace_back(shader_rank, material_rank, vertex_array_rank, i);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  RenderingInfo sorted_info;
+  sorted_info.reserve(info.size());
+  for (const auto& key : keys) {
+    sorted_info.push_back(info[std::get<3>(key)]);
+  }
+  info.swap(sorted_info);
+}
+
 void Renderer::RenderScene(const Scene& scene) const {
   GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
 
@@ -102,6 +190,31 @@ void Renderer::RenderScene(const Scene& scene) const {
   }
 
   CameraComponent* camera = scene.GetActiveCameraPtr();
+  // Camera and material blocks are only re-uploaded when their contents change.
+  CameraBlock camera_block;
+  PackCamera(*camera, camera_block);
+  camera_block_buffer_->UpdateIfChanged(camera_block);
+  camera_block_buffer_->BindToPoint(kCameraBlockBinding);
+  material_block_buffer_->BindToPoint(kMaterialBlockBinding);
+
+  // In deferred mode, objects with a deferred shading model are shaded from the G-buffer, and only
+  // the rest go through the forward passes below.
+  const RenderingInfo* forward_info = &rendering_info;
+  RenderingInfo forward_only_info;
+  if (lighting_mode_ == LightingMode::Deferred) {
+    RenderingInfo deferred_info;
+    for (const auto& pr : rendering_info) {
+      auto shading_ptr = pr.first->GetNodePtr()->GetComponentPtr<ShadingComponent>();
+      if (shading_ptr != nullptr && shading_ptr->GetShaderPtr()->GetDeferredShadingModel() !=
+                                        DeferredShadingModel::None) {
+        deferred_info.push_back(pr);
+      } else {
+        forward_only_info.push_back(pr);
+      }
+    }
+    RenderDeferred(deferred_info, light_ptrs, *camera);
+    forward_info = &forward_only_info;
+  }
 
   {
     // Here we first do a depth pass (note that this has nothing to do with the
@@ -111,11 +224,11 @@ void Renderer::RenderScene(const Scene& scene) const {
     // assignment 5. If you are interested in learning more, see
     // https://www.khronos.org/opengl/wiki/Early_Fragment_Test#Optimization
 
-    GL_CHECK(glDepthMask(GL_TRUE));
-    bool color_mask = GL_FALSE;
-    GL_CHECK(glColorMask(color_mask, color_mask, color_mask, color_mask));
+    gl_state_.SetDepthMask(true);
+    gl_state_.SetColorMask(false);
 
-    for (const auto& pr : rendering_info) {
+    ShaderProgram* bound_shader = nullptr;
+    for (const auto& pr : *forward_info) {
       auto robj_ptr = pr.first;
       SceneNode& node = *robj_ptr->GetNodePtr();
       auto shading_ptr = node.GetComponentPtr<ShadingComponent>();
@@ -126,43 +239,59 @@ void Renderer::RenderScene(const Scene& scene) const {
       }
       ShaderProgram* shader = shading_ptr->GetShaderPtr();
 
-      BindGuard shader_bg(shader);
+      // The queue is sorted by shader, so per shader uniforms only change between groups.
+      if (shader != bound_shader) {
+        shader->Bind();
+        shader->SetCamera(*camera);
+        bound_shader = shader;
+      }
 
       // Set various uniform variables in the shaders.
       shader->SetTargetNode(node, pr.second);
-      shader->SetCamera(*camera);
 
       robj_ptr->Render();
     }
   }
 
-  // The real shadow map/Phong shading passes.
-  for (size_t light_id = 0; light_id < light_ptrs.size(); light_id++) {
-    // If we're rendering the first light (e.g. just putting the primitves down),
+  // The real shadow map/Phong shading passes. Each pass shades a group of lights, which shaders
+  // read from the light block.
+  size_t lights_per_pass = lighting_mode_ == LightingMode::MultiPass ? 1 : kMaxLightsPerPass;
+  light_block_buffer_->BindToPoint(kLightBlockBinding);
+  for (size_t first_light = 0; first_light < light_ptrs.size(); first_light += lights_per_pass) {
+    // If we're rendering the first pass (e.g. just putting the primitves down),
     // don't actually add the pixel values, just substitute them.
     // Otherwise, we add successive rendering passes.
-    if (light_id == 0) {
-      GL_CHECK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+    if (first_light == 0) {
+      gl_state_.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     } else {
-      GL_CHECK(glBlendFunc(GL_ONE, GL_ONE));
+      gl_state_.SetBlendFunc(GL_ONE, GL_ONE);
     }
-    LightComponent& light = *light_ptrs.at(light_id);
-    // Render shadow maps for lights that can cast shadows
+    size_t end_light = std::min(first_light + lights_per_pass, light_ptrs.size());
+    // There's only one shadow map per pass, which goes to the first light that can cast shadows.
+    LightBlock light_block;
+    LightComponent* shadow_light = PackLights(light_ptrs, first_light, end_light, light_block);
+    light_block_buffer_->Update(light_block);
+
+    // Render shadow maps for lights that can cast shadows (if anything is shaded forward)
     glm::mat4 world_to_light_ndc_matrix;
-    if (light.CanCastShadow()) {
+    if (shadow_light != nullptr && !forward_info->empty()) {
       // Create world_to_light_ndc matrix and render shadow
-      auto light_node = light.GetNodePtr();
+      auto light_node = shadow_light->GetNodePtr();
       glm::mat4 light_view_matrix =
           glm::inverse(light_node->GetTransform().GetLocalToWorldMatrix());
       world_to_light_ndc_matrix = kLightProjection * light_view_matrix;
       RenderShadow(world_to_light_ndc_matrix, rendering_info);
     }
 
-    GL_CHECK(glDepthMask(GL_FALSE));
-    bool color_mask = GL_TRUE;
-    GL_CHECK(glColorMask(color_mask, color_mask, color_mask, color_mask));
+    gl_state_.SetDepthMask(false);
+    gl_state_.SetColorMask(true);
 
-    for (const auto& pr : rendering_info) {
+    // Shaders build a variant for the light types (and shadow map) of the pass, instead of
+    // branching on them per fragment.
+    unsigned pass_features =
+        GetLightFeatures(light_block) | (shadow_light != nullptr ? kShadowMapFeature : 0u);
+    ShaderProgram* bound_shader = nullptr;
+    for (const auto& pr : *forward_info) {
       auto robj_ptr = pr.first;
       SceneNode& node = *robj_ptr->GetNodePtr();
       auto shading_ptr = node.GetComponentPtr<ShadingComponent>();
@@ -173,24 +302,215 @@ void Renderer::RenderScene(const Scene& scene) const {
       }
       ShaderProgram* shader = shading_ptr->GetShaderPtr();
 
-      BindGuard shader_bg(shader);
+      // The queue is sorted by shader, so per shader uniforms only change between groups, or when
+      // a node's material needs another variant.
+      bool variant_changed =
+          shader->SelectVariant(pass_features | shader->GetNodeFeatures(node));
+      if (variant_changed || shader != bound_shader) {
+        shader->Bind();
+        shader->SetCamera(*camera);
+        // Pass in the shadow texture to the shader via SetShadowMapping if
+        // a light of the pass can cast shadow.
+        if (shadow_light != nullptr) {
+          shader->SetShadowMapping(*shadow_depth_tex_, world_to_light_ndc_matrix);
+        }
+        bound_shader = shader;
+      }
 
       // Set various uniform variables in the shaders.
+      UpdateMaterialBlock(node);
       shader->SetTargetNode(node, pr.second);
-      shader->SetCamera(*camera);
-      shader->SetLightSource(light);
-      // Pass in the shadow texture to the shader via SetShadowMapping if
-      // the light can cast shadow.
-      if (light.CanCastShadow()) {
-        shader->SetShadowMapping(*shadow_depth_tex_, world_to_light_ndc_matrix);
-      }
 
       robj_ptr->Render();
     }
   }
 
+  if (screen_outline_mode_ != ScreenOutlineMode::None) {
+    RenderScreenOutlines(*forward_info);
+  }
+
   // Re-enable writing to depth buffer.
-  GL_CHECK(glDepthMask(GL_TRUE));
+  gl_state_.SetDepthMask(true);
+}
+
+void Renderer::UpdateMaterialBlock(const SceneNode& node) const {
+  MaterialBlock material_block;
+  PackNodeMaterial(node, material_block);
+  material_block_buffer_->UpdateIfChanged(material_block);
+}
+
+void Renderer::RenderScreenOutlines(const RenderingInfo& rendering_info) const {
+  glm::ivec2 window_size = ReserveScreenBuffers();
+
+  {
+    // Render normals and depth of everything with vertex normals, which leaves out lines such as
+    // mesh based outlines. In deferred mode the G-buffer pass already rendered part of the scene
+    // into the same textures.
+    BindGuard normal_depth_bg(normal_depth_buffer_.get());
+    gl_state_.SetBlend(false);
+    gl_state_.SetDepthMask(true);
+    if (lighting_mode_ != LightingMode::Deferred) {
+      GL_CHECK(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+      GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    }
+
+    BindGuard shader_bg(normal_depth_shader_.get());
+    for (const auto& pr : rendering_info) {
+      auto robj_ptr = pr.first;
+      if (!robj_ptr->GetVertexObjectPtr()->HasNormals()) {
+        continue;
+      }
+      normal_depth_shader_->SetTargetNode(*robj_ptr->GetNodePtr(), pr.second);
+      robj_ptr->Render();
+    }
+  }
+
+  gl_state_.SetDepthTest(false);
+  if (screen_outline_mode_ == ScreenOutlineMode::JumpFlood) {
+    RenderJumpFloodOutlines(window_size);
+  } else {
+    RenderEdgeDetectionOutlines(window_size);
+  }
+  gl_state_.SetDepthTest(true);
+}
+
+glm::ivec2 Renderer::ReserveScreenBuffers() const {
+  glm::ivec2 window_size = application_.GetWindowSize();
+  if (window_size == screen_buffer_size_) {
+    return window_size;
+  }
+  normal_depth_tex_->BindToUnit(0);
+  normal_depth_tex_->Reserve(GL_RGBA32F, window_size.x, window_size.y, GL_RGBA, GL_FLOAT);
+  screen_depth_tex_->BindToUnit(0);
+  screen_depth_tex_->Reserve(GL_DEPTH_COMPONENT, window_size.x, window_size.y,
+                             GL_DEPTH_COMPONENT, GL_FLOAT);
+  for (auto& seed_texture : seed_textures_) {
+    seed_texture->BindToUnit(0);
+    seed_texture->Reserve(GL_RG32F, window_size.x, window_size.y, GL_RG, GL_FLOAT);
+  }
+  low_color_tex_->BindToUnit(0);
+  low_color_tex_->Reserve(GL_RGBA16F, window_size.x, window_size.y, GL_RGBA, GL_FLOAT);
+  high_color_tex_->BindToUnit(0);
+  high_color_tex_->Reserve(GL_RGBA16F, window_size.x, window_size.y, GL_RGBA, GL_FLOAT);
+  material_tex_->BindToUnit(0);
+  material_tex_->Reserve(GL_RG16F, window_size.x, window_size.y, GL_RG, GL_FLOAT);
+  screen_buffer_size_ = window_size;
+  return window_size;
+}
+
+void Renderer::RenderDeferred(const RenderingInfo& rendering_info,
+                              const std::vector<LightComponent*>& light_ptrs,
+                              const CameraComponent& camera) const {
+  ReserveScreenBuffers();
+
+  {
+    // Rasterize the geometry once, into the G-buffer
+    BindGuard g_buffer_bg(g_buffer_.get());
+    gl_state_.SetBlend(false);
+    gl_state_.SetDepthMask(true);
+    gl_state_.SetColorMask(true);
+    GL_CHECK(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+    GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+    BindGuard shader_bg(g_buffer_shader_.get());
+    for (const auto& pr : rendering_info) {
+      SceneNode& node = *pr.first->GetNodePtr();
+      UpdateMaterialBlock(node);
+      g_buffer_shader_->SetShadingModel(
+          node.GetComponentPtr<ShadingComponent>()->GetShaderPtr()->GetDeferredShadingModel());
+      g_buffer_shader_->SetTargetNode(node, pr.second);
+      pr.first->Render();
+    }
+  }
+
+  // Light the G-buffer in screen space. The first pass also writes the G-buffer depth, so forward
+  // shaded objects are still hidden behind deferred ones.
+  gl_state_.SetBlend(true);
+  gl_state_.SetDepthFunc(GL_ALWAYS);
+  BindGuard shader_bg(deferred_lighting_shader_.get());
+  deferred_lighting_shader_->SetVertexObject(*quad_);
+  deferred_lighting_shader_->SetCamera(camera);
+  deferred_lighting_shader_->SetGBuffer(*normal_depth_tex_, *low_color_tex_, *high_color_tex_,
+                                        *material_tex_, *screen_depth_tex_);
+  light_block_buffer_->BindToPoint(kLightBlockBinding);
+  for (size_t first_light = 0; first_light < light_ptrs.size(); first_light += kMaxLightsPerPass) {
+    if (first_light == 0) {
+      gl_state_.SetDepthMask(true);
+      gl_state_.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    } else {
+      gl_state_.SetDepthMask(false);
+      gl_state_.SetBlendFunc(GL_ONE, GL_ONE);
+    }
+    // The tone mapping and toon equations don't use shadow maps
+    LightBlock light_block;
+    PackLights(light_ptrs, first_light,
+               std::min(first_light + kMaxLightsPerPass, light_ptrs.size()), light_block);
+    light_block_buffer_->Update(light_block);
+    quad_->GetVertexArray().Render();
+  }
+  gl_state_.SetDepthFunc(GL_LEQUAL);
+}
+
+void Renderer::RenderEdgeDetectionOutlines(const glm::ivec2& window_size) const {
+  // Blend the detected edges over the shaded scene
+  gl_state_.SetBlend(true);
+  gl_state_.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  BindGuard shader_bg(edge_detection_shader_.get());
+  edge_detection_shader_->SetVertexObject(*quad_);
+  edge_detection_shader_->SetNormalDepthTexture(*normal_depth_tex_, window_size);
+  edge_detection_shader_->SetOutlineStyle(
+      screen_outline_style_.color, screen_outline_style_.thickness,
+      screen_outline_style_.silhouettes, screen_outline_style_.creases,
+      screen_outline_style_.cos_crease_threshold);
+  edge_detection_shader_->SetSeedOutput(false);
+  quad_->GetVertexArray().Render();
+}
+
+void Renderer::RenderJumpFloodOutlines(const glm::ivec2& window_size) const {
+  gl_state_.SetBlend(false);
+  // Pixels without a seed hold negative coordinates
+  GL_CHECK(glClearColor(-1.0f, -1.0f, 0.0f, 0.0f));
+  {
+    // Seed with the thinnest edges the detection finds (about a pixel on each side)
+    BindGuard seed_buffer_bg(seed_buffers_[0].get());
+    GL_CHECK(glClear(GL_COLOR_BUFFER_BIT));
+    BindGuard shader_bg(edge_detection_shader_.get());
+    edge_detection_shader_->SetVertexObject(*quad_);
+    edge_detection_shader_->SetNormalDepthTexture(*normal_depth_tex_, window_size);
+    edge_detection_shader_->SetOutlineStyle(
+        screen_outline_style_.color, 2.0f, screen_outline_style_.silhouettes,
+        screen_outline_style_.creases, screen_outline_style_.cos_crease_threshold);
+    edge_detection_shader_->SetSeedOutput(true);
+    quad_->GetVertexArray().Render();
+  }
+
+  // Flood from the largest power of two step below the outline radius down to 1
+  int step = 1;
+  while (2 * step < 0.5f * screen_outline_style_.thickness) {
+    step *= 2;
+  }
+  int source = 0;
+  {
+    BindGuard shader_bg(jump_flood_shader_.get());
+    jump_flood_shader_->SetVertexObject(*quad_);
+    for (; step >= 1; step /= 2) {
+      BindGuard seed_buffer_bg(seed_buffers_[1 - source].get());
+      jump_flood_shader_->SetSeedTexture(*seed_textures_[source]);
+      jump_flood_shader_->SetStep(step);
+      quad_->GetVertexArray().Render();
+      source = 1 - source;
+    }
+  }
+
+  // Blend everything within the outline radius of a seed over the shaded scene
+  gl_state_.SetBlend(true);
+  gl_state_.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  BindGuard shader_bg(distance_outline_shader_.get());
+  distance_outline_shader_->SetVertexObject(*quad_);
+  distance_outline_shader_->SetSeedTexture(*seed_textures_[source]);
+  distance_outline_shader_->SetOutlineStyle(screen_outline_style_.color,
+                                            screen_outline_style_.thickness);
+  quad_->GetVertexArray().Render();
 }
 
 void Renderer::RenderShadow(const glm::mat4& world_to_light_ndc_matrix,
@@ -200,9 +520,9 @@ void Renderer::RenderShadow(const glm::mat4& world_to_light_ndc_matrix,
 
   // Set up shadow map rendering context
   GL_CHECK(glViewport(0, 0, kShadowWidth, kShadowHeight));
-  GL_CHECK(glDepthMask(GL_TRUE));
+  gl_state_.SetDepthMask(true);
   // don't render colors to shadow buffer
-  GL_CHECK(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+  gl_state_.SetColorMask(false);
   // clear depth buffer for shadow buffer (only do this when the framebuffer is complete)
   GL_CHECK(glClear(GL_DEPTH_BUFFER_BIT));
 
@@ -234,8 +554,8 @@ void Renderer::RenderTexturedQuad(const Texture& texture, bool is_depth) const {
 }
 
 void Renderer::DebugShadowMap() const {
-  GL_CHECK(glDisable(GL_DEPTH_TEST));
-  GL_CHECK(glDisable(GL_BLEND));
+  gl_state_.SetDepthTest(false);
+  gl_state_.SetBlend(false);
 
   glm::ivec2 window_size = application_.GetWindowSize();
   glViewport(0, 0, window_size.x / 4, window_size.y / 4);
@@ -6,18 +6,56 @@
 #include "components/LightComponent.hpp"
 #include "components/RenderingComponent.hpp"
 #include "gl_wrapper/Framebuffer.hpp"
+#include "gl_wrapper/GLStateCache.hpp"
 #include "gl_wrapper/Texture.hpp"
+#include "gl_wrapper/UniformBuffer.hpp"
+#include "shaders/CameraBlock.hpp"
+#include "shaders/DeferredLightingShader.hpp"
+#include "shaders/EdgeDetectionShader.hpp"
+#include "shaders/GBufferShader.hpp"
+#include "shaders/JumpFloodShader.hpp"
+#include "shaders/LightBlock.hpp"
+#include "shaders/MaterialBlock.hpp"
+#include "shaders/NormalDepthShader.hpp"
 #include "shaders/PlainTextureShader.hpp"
 #include "shaders/ShadowShader.hpp"
 
 namespace GLOO {
 class Scene;
 class Application;
+class CameraComponent;
+
+// Outlines the renderer draws itself from screen space buffers, on top of the shaded scene.
+// EdgeDetection finds depth and normal discontinuities of all surfaces with vertex normals.
+// JumpFlood thickens the same edges with a jump flooding distance transform, which gives round
+// joins and costs log2(thickness) full screen passes however wide the lines are.
+enum class ScreenOutlineMode { None, EdgeDetection, JumpFlood };
+
+// How lights are shaded. SinglePass packs up to kMaxLightsPerPass lights into the light block
+// and shades all of them in one pass over the scene, but only the first light of a pass that can
+// cast shadows gets a shadow map. MultiPass (the default) shades each light in its own additive
+// pass, so every directional light casts shadows. Deferred rasterizes objects with a tone mapping
+// or toon shader once into a G-buffer and applies the lights in screen space (without shadows), so
+// their shading cost scales with pixels instead of triangles. Other objects are shaded forward in
+// single passes.
+enum class LightingMode { SinglePass, MultiPass, Deferred };
+
+struct ScreenOutlineStyle {
+  glm::vec3 color = glm::vec3(1.0f);
+  float thickness = 4.0f;  // in pixels
+  bool silhouettes = true;
+  bool creases = true;
+  float cos_crease_threshold = 0.8660254f;  // cos(30 degrees)
+};
+
 class Renderer {
  public:
   Renderer(Application& application);
   void Render(const Scene& scene) const;
   void SetBackgroundColor(const glm::vec4& color);
+  void SetLightingMode(LightingMode mode);
+  void SetScreenOutlineMode(ScreenOutlineMode mode);
+  void SetScreenOutlineStyle(const ScreenOutlineStyle& style);
 
  private:
   using RenderingInfo = std::vector<std::pair<RenderingComponent*, glm::mat4>>;
@@ -25,6 +63,7 @@ class Renderer {
   void SetRenderingOptions() const;
 
   RenderingInfo RetrieveRenderingInfo(const Scene& scene) const;
+  static void SortRenderQueue(RenderingInfo& info);
   static void RecursiveRetrieve(const SceneNode& node,
                                 RenderingInfo& info,
                                 const glm::mat4& model_matrix);
@@ -34,6 +73,19 @@ class Renderer {
                     const RenderingInfo& rendering_info) const;
 
   void RenderTexturedQuad(const Texture& texture, bool is_depth) const;
+  // (Re)allocates the window sized buffers if the window size changed, and returns the size.
+  glm::ivec2 ReserveScreenBuffers() const;
+  // Uploads the material of `node` to the material block, if it differs from the current one.
+  void UpdateMaterialBlock(const SceneNode& node) const;
+  void RenderDeferred(const RenderingInfo& rendering_info,
+                      const std::vector<LightComponent*>& light_ptrs,
+                      const CameraComponent& camera) const;
+  // In deferred mode, `rendering_info` only holds the forward shaded objects, since the others'
+  // normals and depth are already in the G-buffer.
+  void RenderScreenOutlines(const RenderingInfo& rendering_info) const;
+  // Blends outlines into the current framebuffer from the normal/depth buffer
+  void RenderEdgeDetectionOutlines(const glm::ivec2& window_size) const;
+  void RenderJumpFloodOutlines(const glm::ivec2& window_size) const;
   void DebugShadowMap() const;
 
   glm::vec4 background_color_;
@@ -41,6 +93,34 @@ class Renderer {
   std::unique_ptr<Framebuffer> shadow_buffer_;
   std::unique_ptr<ShadowShader> shadow_shader_;
   std::unique_ptr<PlainTextureShader> plain_texture_shader_;
+
+  LightingMode lighting_mode_ = LightingMode::MultiPass;
+  std::unique_ptr<UniformBuffer<LightBlock>> light_block_buffer_;
+  std::unique_ptr<UniformBuffer<CameraBlock>> camera_block_buffer_;
+  std::unique_ptr<UniformBuffer<MaterialBlock>> material_block_buffer_;
+
+  ScreenOutlineMode screen_outline_mode_ = ScreenOutlineMode::None;
+  ScreenOutlineStyle screen_outline_style_;
+  // Window sized normal/depth buffer, reallocated when the window size changes
+  std::unique_ptr<Texture> normal_depth_tex_;
+  std::unique_ptr<Texture> screen_depth_tex_;
+  std::unique_ptr<Framebuffer> normal_depth_buffer_;
+  mutable glm::ivec2 screen_buffer_size_{0, 0};
+  // G-buffer of deferred rendering, which shares the normal/depth buffer's textures
+  std::unique_ptr<Texture> low_color_tex_;
+  std::unique_ptr<Texture> high_color_tex_;
+  std::unique_ptr<Texture> material_tex_;
+  std::unique_ptr<Framebuffer> g_buffer_;
+  std::unique_ptr<GBufferShader> g_buffer_shader_;
+  std::unique_ptr<DeferredLightingShader> deferred_lighting_shader_;
+  std::unique_ptr<NormalDepthShader> normal_depth_shader_;
+  std::unique_ptr<EdgeDetectionShader> edge_detection_shader_;
+  // Ping-pong buffers of the jump flooding passes, same size as the normal/depth buffer
+  std::unique_ptr<Texture> seed_textures_[2];
+  std::unique_ptr<Framebuffer> seed_buffers_[2];
+  std::unique_ptr<JumpFloodShader> jump_flood_shader_;
+  std::unique_ptr<DistanceOutlineShader> distance_outline_shader_;
+  GLStateCache& gl_state_;
   Application& application_;
 };
 }  // namespace GLOO
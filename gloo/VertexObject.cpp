@@ -16,6 +16,14 @@ void VertexObject::UpdatePositions(std::unique_ptr<PositionArray> positions) {
   vertex_array_->UpdatePositions(*positions_);
 }
 
+void VertexObject::SwapPositions(std::unique_ptr<PositionArray>& positions) {
+  if (positions_ == nullptr) {
+    vertex_array_->CreatePositionBuffer();
+  }
+  positions_.swap(positions);
+  vertex_array_->UpdatePositions(*positions_);
+}
+
 void VertexObject::UpdateIndices(std::unique_ptr<IndexArray> indices) {
   if (indices_ == nullptr) {
     vertex_array_->CreateIndexBuffer();
@@ -24,6 +32,19 @@ void VertexObject::UpdateIndices(std::unique_ptr<IndexArray> indices) {
   vertex_array_->UpdateIndices(*indices_);
 }
 
+void VertexObject::UpdateIndexRange(size_t first, const IndexArray& tail) {
+  if (indices_ == nullptr) {
+    vertex_array_->CreateIndexBuffer();
+    indices_ = make_unique<IndexArray>();
+  }
+  if (first > indices_->size()) {
+    throw std::runtime_error("Index range starts past the end of the indices!");
+  }
+  indices_->resize(first);
+  indices_->insert(indices_->end(), tail.begin(), tail.end());
+  vertex_array_->UpdateIndices(*indices_, first);
+}
+
 void VertexObject::UpdateNormals(std::unique_ptr<NormalArray> normals) {
   if (normals_ == nullptr) {
     vertex_array_->CreateNormalBuffer();
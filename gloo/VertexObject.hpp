@@ -17,6 +17,12 @@ class VertexObject {
   void UpdateColors(std::unique_ptr<ColorArray> colors);
   void UpdateTexCoord(std::unique_ptr<TexCoordArray> tex_coords);
   void UpdateIndices(std::unique_ptr<IndexArray> indices);
+  // Uploads `positions` and hands the previously owned array (or nullptr) back through the same
+  // pointer, so positions rebuilt every frame can reuse its allocation.
+  void SwapPositions(std::unique_ptr<PositionArray>& positions);
+  // Keeps the first `first` indices and replaces the rest with `tail`. Only the replaced range is
+  // uploaded, unless the index buffer has to grow.
+  void UpdateIndexRange(size_t first, const IndexArray& tail);
 
   bool HasPositions() const {
     return positions_ != nullptr;
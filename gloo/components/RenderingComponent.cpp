@@ -22,11 +22,25 @@ void RenderingComponent::SetDrawRange(int start_index, int num_indices) {
   num_indices_ = num_indices;
 }
 
+void RenderingComponent::SetDrawRanges(const std::vector<GLint>& firsts,
+                                       const std::vector<GLsizei>& counts) {
+  if (firsts.size() != counts.size()) {
+    throw std::runtime_error("Draw range firsts and counts must have the same size!");
+  }
+  // Copy into the existing storage rather than taking ownership, so it's reused across updates
+  range_firsts_.assign(firsts.begin(), firsts.end());
+  range_counts_.assign(counts.begin(), counts.end());
+}
+
 void RenderingComponent::Render() const {
   if (vertex_obj_ == nullptr) {
     throw std::runtime_error(
         "Rendering component has no vertex object attached!");
   }
+  if (!range_firsts_.empty()) {
+    vertex_obj_->GetVertexArray().Render(range_firsts_, range_counts_);
+    return;
+  }
   if (start_index_ >= 0 && num_indices_ > 0) {
     vertex_obj_->GetVertexArray().Render(static_cast<size_t>(start_index_),
                                          static_cast<size_t>(num_indices_));
@@ -55,6 +69,14 @@ void RenderingComponent::SetPolygonMode(PolygonMode mode) {
   vertex_obj_->GetVertexArray().SetPolygonMode(mode);
 }
 
+void RenderingComponent::SetCullMode(CullMode mode) {
+  if (vertex_obj_ == nullptr) {
+    throw std::runtime_error(
+        "Rendering component has no vertex object attached!");
+  }
+  vertex_obj_->GetVertexArray().SetCullMode(mode);
+}
+
 void RenderingComponent::SetVertexObject(
     std::shared_ptr<VertexObject> vertex_obj) {
   vertex_obj_ = vertex_obj;
@@ -10,9 +10,13 @@ class RenderingComponent : public ComponentBase {
  public:
   RenderingComponent(std::shared_ptr<VertexObject> vertex_obj);
   void SetDrawRange(int start_index, int num_indices);
+  // Renders several vertex ranges with one draw call instead of a single range. Pass empty
+  // vectors to go back to single range rendering.
+  void SetDrawRanges(const std::vector<GLint>& firsts, const std::vector<GLsizei>& counts);
   void SetVertexObject(std::shared_ptr<VertexObject> vertex_obj);
   void SetDrawMode(DrawMode mode);
   void SetPolygonMode(PolygonMode mode);
+  void SetCullMode(CullMode mode);
   VertexObject* GetVertexObjectPtr() {
     return vertex_obj_.get();
   }
@@ -23,6 +27,8 @@ class RenderingComponent : public ComponentBase {
   std::shared_ptr<VertexObject> vertex_obj_;
   int start_index_;
   int num_indices_;
+  std::vector<GLint> range_firsts_;
+  std::vector<GLsizei> range_counts_;
 };
 
 CREATE_COMPONENT_TRAIT(RenderingComponent, ComponentType::Rendering);
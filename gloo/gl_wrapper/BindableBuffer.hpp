@@ -23,6 +23,9 @@ class BindableBuffer : public IBindable {
 
   void Bind() const override;
   void Unbind() const override;
+  GLuint GetHandle() const {
+    return handle_;
+  }
 
  private:
   GLuint handle_;
@@ -45,6 +45,12 @@ void Framebuffer::AssociateTexture(const Texture& texture, GLenum attachment) {
   Unbind();
 }
 
+void Framebuffer::SetDrawBuffers(const std::vector<GLenum>& attachments) {
+  Bind();
+  GL_CHECK(glDrawBuffers((GLsizei)attachments.size(), attachments.data()));
+  Unbind();
+}
+
 static_assert(std::is_move_constructible<Framebuffer>(), "");
 static_assert(std::is_move_assignable<Framebuffer>(), "");
 
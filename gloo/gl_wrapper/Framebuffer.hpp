@@ -1,6 +1,8 @@
 #ifndef GLOO_FRAMEBUFFER_H_
 #define GLOO_FRAMEBUFFER_H_
 
+#include <vector>
+
 #include "BindGuard.hpp"
 #include "gloo/external.hpp"
 #include "Texture.hpp"
@@ -21,6 +23,8 @@ class Framebuffer : public IBindable {
   void Bind() const override;
   void Unbind() const override;
   void AssociateTexture(const Texture& texture, GLenum attachment);
+  // Sets the color attachments fragment shader outputs are written to, in output location order.
+  void SetDrawBuffers(const std::vector<GLenum>& attachments);
 
  private:
   GLuint handle_{GLuint(-1)};
@@ -0,0 +1,105 @@
+#include "GLStateCache.hpp"
+
+#include "gloo/utils.hpp"
+
+namespace GLOO {
+namespace {
+void SetCapability(GLenum capability, bool enabled) {
+  if (enabled) {
+    GL_CHECK(glEnable(capability));
+  } else {
+    GL_CHECK(glDisable(capability));
+  }
+}
+}  // namespace
+
+void GLStateCache::Invalidate() {
+  program_.Invalidate();
+  vertex_array_.Invalidate();
+  polygon_mode_.Invalidate();
+  cull_face_enabled_.Invalidate();
+  cull_face_.Invalidate();
+  blend_.Invalidate();
+  blend_func_.Invalidate();
+  depth_test_.Invalidate();
+  depth_mask_.Invalidate();
+  depth_func_.Invalidate();
+  color_mask_.Invalidate();
+}
+
+void GLStateCache::ForgetProgram(GLuint program) {
+  if (program_.Holds(program)) {
+    program_.Invalidate();
+  }
+}
+
+void GLStateCache::ForgetVertexArray(GLuint vertex_array) {
+  if (vertex_array_.Holds(vertex_array)) {
+    vertex_array_.Invalidate();
+  }
+}
+
+void GLStateCache::UseProgram(GLuint program) {
+  if (program_.Set(program)) {
+    GL_CHECK(glUseProgram(program));
+  }
+}
+
+void GLStateCache::BindVertexArray(GLuint vertex_array) {
+  if (vertex_array_.Set(vertex_array)) {
+    GL_CHECK(glBindVertexArray(vertex_array));
+  }
+}
+
+void GLStateCache::SetPolygonMode(GLenum mode) {
+  if (polygon_mode_.Set(mode)) {
+    GL_CHECK(glPolygonMode(GL_FRONT_AND_BACK, mode));
+  }
+}
+
+void GLStateCache::SetCullFace(bool enabled, GLenum face) {
+  if (cull_face_enabled_.Set(enabled)) {
+    SetCapability(GL_CULL_FACE, enabled);
+  }
+  if (enabled && cull_face_.Set(face)) {
+    GL_CHECK(glCullFace(face));
+  }
+}
+
+void GLStateCache::SetBlend(bool enabled) {
+  if (blend_.Set(enabled)) {
+    SetCapability(GL_BLEND, enabled);
+  }
+}
+
+void GLStateCache::SetBlendFunc(GLenum source_factor, GLenum destination_factor) {
+  if (blend_func_.Set(std::make_pair(source_factor, destination_factor))) {
+    GL_CHECK(glBlendFunc(source_factor, destination_factor));
+  }
+}
+
+void GLStateCache::SetDepthTest(bool enabled) {
+  if (depth_test_.Set(enabled)) {
+    SetCapability(GL_DEPTH_TEST, enabled);
+  }
+}
+
+void GLStateCache::SetDepthMask(bool enabled) {
+  if (depth_mask_.Set(enabled)) {
+    GL_CHECK(glDepthMask(enabled ? GL_TRUE : GL_FALSE));
+  }
+}
+
+void GLStateCache::SetDepthFunc(GLenum func) {
+  if (depth_func_.Set(func)) {
+    GL_CHECK(glDepthFunc(func));
+  }
+}
+
+void GLStateCache::SetColorMask(bool enabled) {
+  if (color_mask_.Set(enabled)) {
+    GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+    GL_CHECK(glColorMask(mask, mask, mask, mask));
+  }
+}
+}  // namespace GLOO
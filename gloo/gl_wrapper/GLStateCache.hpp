@@ -0,0 +1,85 @@
+#ifndef GLOO_GL_STATE_CACHE_H_
+#define GLOO_GL_STATE_CACHE_H_
+
+#include <utility>
+
+#include <glad/glad.h>
+
+namespace GLOO {
+/**
+ * Shadow copy of the GL state that changes between draws, which skips calls that wouldn't change
+ * anything. All changes to this state should go through the cache. Code that changes it behind
+ * the cache's back (e.g. the GUI) has to be followed by Invalidate().
+ */
+class GLStateCache {
+ public:
+  // Singleton design pattern, like InputManager.
+  static GLStateCache& GetInstance() {
+    static GLStateCache _instance;
+    return _instance;
+  }
+
+  GLStateCache(const GLStateCache&) = delete;
+  void operator=(const GLStateCache&) = delete;
+
+  // Forgets all cached state, so the next call of each setter reaches GL.
+  void Invalidate();
+  // Called when objects are deleted, since GL may hand their names out again.
+  void ForgetProgram(GLuint program);
+  void ForgetVertexArray(GLuint vertex_array);
+
+  void UseProgram(GLuint program);
+  void BindVertexArray(GLuint vertex_array);
+  void SetPolygonMode(GLenum mode);
+  // `face` is ignored while culling is disabled.
+  void SetCullFace(bool enabled, GLenum face);
+  void SetBlend(bool enabled);
+  void SetBlendFunc(GLenum source_factor, GLenum destination_factor);
+  void SetDepthTest(bool enabled);
+  void SetDepthMask(bool enabled);
+  void SetDepthFunc(GLenum func);
+  void SetColorMask(bool enabled);
+
+ private:
+  GLStateCache() = default;
+
+  // A cached value, which is unknown until it's first set.
+  template <class T>
+  class CachedState {
+   public:
+    // Records `value` and returns whether GL has to be updated.
+    bool Set(const T& value) {
+      if (known_ && value_ == value) {
+        return false;
+      }
+      value_ = value;
+      known_ = true;
+      return true;
+    }
+    bool Holds(const T& value) const {
+      return known_ && value_ == value;
+    }
+    void Invalidate() {
+      known_ = false;
+    }
+
+   private:
+    T value_{};
+    bool known_ = false;
+  };
+
+  CachedState<GLuint> program_;
+  CachedState<GLuint> vertex_array_;
+  CachedState<GLenum> polygon_mode_;
+  CachedState<bool> cull_face_enabled_;
+  CachedState<GLenum> cull_face_;
+  CachedState<bool> blend_;
+  CachedState<std::pair<GLenum, GLenum>> blend_func_;
+  CachedState<bool> depth_test_;
+  CachedState<bool> depth_mask_;
+  CachedState<GLenum> depth_func_;
+  CachedState<bool> color_mask_;
+};
+}  // namespace GLOO
+
+#endif
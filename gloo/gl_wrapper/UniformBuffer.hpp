@@ -0,0 +1,61 @@
+#ifndef GLOO_UNIFORM_BUFFER_H_
+#define GLOO_UNIFORM_BUFFER_H_
+
+#include "BindableBuffer.hpp"
+
+#include <cstring>
+
+#include <glad/glad.h>
+
+#include "BindGuard.hpp"
+#include "gloo/utils.hpp"
+
+namespace GLOO {
+// Buffer backing a uniform block. `T` must match the std140 layout of the block in GLSL.
+template <class T>
+class UniformBuffer : public BindableBuffer {
+ public:
+  UniformBuffer();
+  void Update(const T& block);
+  // Uploads `block` only if it differs from the last uploaded contents. Returns whether it did.
+  bool UpdateIfChanged(const T& block);
+  // Attaches the buffer to `binding`, which shaders link their block to (see
+  // ShaderProgram::BindUniformBlock).
+  void BindToPoint(GLuint binding) const;
+
+ private:
+  T contents_;
+  bool has_contents_ = false;
+};
+
+template <class T>
+UniformBuffer<T>::UniformBuffer() : BindableBuffer(GL_UNIFORM_BUFFER) {
+  BindGuard bg(this);
+  GL_CHECK(glBufferData(target_, sizeof(T), nullptr, GL_DYNAMIC_DRAW));
+}
+
+template <class T>
+void UniformBuffer<T>::Update(const T& block) {
+  BindGuard bg(this);
+  GL_CHECK(glBufferSubData(target_, 0, sizeof(T), &block));
+  contents_ = block;
+  has_contents_ = true;
+}
+
+template <class T>
+bool UniformBuffer<T>::UpdateIfChanged(const T& block) {
+  // Blocks are plain std140 structs with explicit padding, so comparing bytes is enough.
+  if (has_contents_ && std::memcmp(&contents_, &block, sizeof(T)) == 0) {
+    return false;
+  }
+  Update(block);
+  return true;
+}
+
+template <class T>
+void UniformBuffer<T>::BindToPoint(GLuint binding) const {
+  GL_CHECK(glBindBufferBase(target_, binding, GetHandle()));
+}
+}  // namespace GLOO
+
+#endif
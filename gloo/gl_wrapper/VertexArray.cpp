@@ -3,17 +3,48 @@
 #include <iostream>
 
 #include "BindGuard.hpp"
+#include "GLStateCache.hpp"
 #include "gloo/utils.hpp"
 
 namespace GLOO {
+namespace {
+GLenum GetGLDrawMode(DrawMode mode) {
+  switch (mode) {
+    case DrawMode::Lines:
+      return GL_LINES;
+    case DrawMode::TrianglesAdjacency:
+      return GL_TRIANGLES_ADJACENCY;
+    default:
+      return GL_TRIANGLES;
+  }
+}
+
+void ApplyRasterModes(PolygonMode polygon_mode, CullMode cull_mode) {
+  GLStateCache& gl_state = GLStateCache::GetInstance();
+  gl_state.SetPolygonMode(polygon_mode == PolygonMode::Wireframe ? GL_LINE : GL_FILL);
+  gl_state.SetCullFace(cull_mode != CullMode::None,
+                       cull_mode == CullMode::Front ? GL_FRONT : GL_BACK);
+}
+
+// Element array bindings are part of the bound vertex array, so updating an index buffer while a
+// vertex array is bound would detach that array's indices.
+void UnbindVertexArrayForIndexUpdate() {
+  GLStateCache::GetInstance().BindVertexArray(0);
+}
+}  // namespace
+
 VertexArray::VertexArray()
-    : draw_mode_(DrawMode::Triangles), polygon_mode_(PolygonMode::Fill) {
+    : draw_mode_(DrawMode::Triangles),
+      polygon_mode_(PolygonMode::Fill),
+      cull_mode_(CullMode::None) {
   GL_CHECK(glGenVertexArrays(1, &handle_));
 }
 
 VertexArray::~VertexArray() {
-  if (handle_ != GLuint(-1))
+  if (handle_ != GLuint(-1)) {
+    GLStateCache::GetInstance().ForgetVertexArray(handle_);
     GL_CHECK(glDeleteVertexArrays(1, &handle_));
+  }
 }
 
 VertexArray::VertexArray(VertexArray&& other) noexcept {
@@ -25,8 +56,13 @@ VertexArray::VertexArray(VertexArray&& other) noexcept {
   color_buf_ = std::move(other.color_buf_);
   tex_coord_buf_ = std::move(other.tex_coord_buf_);
   idx_buf_ = std::move(other.idx_buf_);
+  pos_attr_idx_ = other.pos_attr_idx_;
+  normal_attr_idx_ = other.normal_attr_idx_;
+  color_attr_idx_ = other.color_attr_idx_;
+  tex_coord_attr_idx_ = other.tex_coord_attr_idx_;
   draw_mode_ = other.draw_mode_;
   polygon_mode_ = other.polygon_mode_;
+  cull_mode_ = other.cull_mode_;
 }
 
 VertexArray& VertexArray::operator=(VertexArray&& other) noexcept {
@@ -38,33 +74,42 @@ VertexArray& VertexArray::operator=(VertexArray&& other) noexcept {
   color_buf_ = std::move(other.color_buf_);
   tex_coord_buf_ = std::move(other.tex_coord_buf_);
   idx_buf_ = std::move(other.idx_buf_);
+  pos_attr_idx_ = other.pos_attr_idx_;
+  normal_attr_idx_ = other.normal_attr_idx_;
+  color_attr_idx_ = other.color_attr_idx_;
+  tex_coord_attr_idx_ = other.tex_coord_attr_idx_;
   draw_mode_ = other.draw_mode_;
   polygon_mode_ = other.polygon_mode_;
+  cull_mode_ = other.cull_mode_;
   return *this;
 }
 
 void VertexArray::Bind() const {
-  GL_CHECK(glBindVertexArray(handle_));
+  GLStateCache::GetInstance().BindVertexArray(handle_);
 }
 
 void VertexArray::Unbind() const {
-  GL_CHECK(glBindVertexArray(0));
+  GLStateCache::GetInstance().BindVertexArray(0);
 }
 
 void VertexArray::CreatePositionBuffer() {
   pos_buf_ = make_unique<PositionBuffer>(GL_STATIC_DRAW);
+  pos_attr_idx_ = -1;
 }
 
 void VertexArray::CreateNormalBuffer() {
   normal_buf_ = make_unique<NormalBuffer>(GL_STATIC_DRAW);
+  normal_attr_idx_ = -1;
 }
 
 void VertexArray::CreateColorBuffer() {
   color_buf_ = make_unique<ColorBuffer>(GL_STATIC_DRAW);
+  color_attr_idx_ = -1;
 }
 
 void VertexArray::CreateTexCoordBuffer() {
   tex_coord_buf_ = make_unique<TexCoordBuffer>(GL_STATIC_DRAW);
+  tex_coord_attr_idx_ = -1;
 }
 
 void VertexArray::CreateIndexBuffer() {
@@ -90,40 +135,43 @@ void VertexArray::UpdateTexCoords(const TexCoordArray& tex_coords) const {
   tex_coord_buf_->Update(tex_coords);
 }
 
-void VertexArray::UpdateIndices(const IndexArray& indices) const {
-  idx_buf_->Update(indices);
+void VertexArray::UpdateIndices(const IndexArray& indices, size_t first_changed) const {
+  UnbindVertexArrayForIndexUpdate();
+  idx_buf_->Update(indices, first_changed);
 }
 
-void VertexArray::LinkPositionBuffer(GLuint attr_idx) const {
+void VertexArray::ReserveIndices(size_t count) const {
+  UnbindVertexArrayForIndexUpdate();
+  idx_buf_->Reserve(count);
+}
+
+void VertexArray::LinkBuffer(const IBindable* buffer, GLuint attr_idx, GLint num_components,
+                             GLint& linked_attr_idx) const {
+  if (linked_attr_idx == static_cast<GLint>(attr_idx)) {
+    return;
+  }
   BindGuard vao_bg(this);
-  BindGuard buf_bg(pos_buf_.get());
+  BindGuard buf_bg(buffer);
   // The line below attaches the vertex buffer to the VAO.
-  GL_CHECK(glVertexAttribPointer(attr_idx, 3, GL_FLOAT, GL_FALSE, 0, 0));
+  GL_CHECK(glVertexAttribPointer(attr_idx, num_components, GL_FLOAT, GL_FALSE, 0, 0));
   GL_CHECK(glEnableVertexAttribArray(attr_idx));
+  linked_attr_idx = static_cast<GLint>(attr_idx);
+}
+
+void VertexArray::LinkPositionBuffer(GLuint attr_idx) const {
+  LinkBuffer(pos_buf_.get(), attr_idx, 3, pos_attr_idx_);
 }
 
 void VertexArray::LinkNormalBuffer(GLuint attr_idx) const {
-  BindGuard vao_bg(this);
-  BindGuard buf_bg(normal_buf_.get());
-  // The line below attaches the vertex buffer to the VAO.
-  GL_CHECK(glVertexAttribPointer(attr_idx, 3, GL_FLOAT, GL_FALSE, 0, 0));
-  GL_CHECK(glEnableVertexAttribArray(attr_idx));
+  LinkBuffer(normal_buf_.get(), attr_idx, 3, normal_attr_idx_);
 }
 
 void VertexArray::LinkColorBuffer(GLuint attr_idx) const {
-  BindGuard vao_bg(this);
-  BindGuard buf_bg(color_buf_.get());
-  // The line below attaches the vertex buffer to the VAO.
-  GL_CHECK(glVertexAttribPointer(attr_idx, 4, GL_FLOAT, GL_FALSE, 0, 0));
-  GL_CHECK(glEnableVertexAttribArray(attr_idx));
+  LinkBuffer(color_buf_.get(), attr_idx, 4, color_attr_idx_);
 }
 
 void VertexArray::LinkTexCoordBuffer(GLuint attr_idx) const {
-  BindGuard vao_bg(this);
-  BindGuard buf_bg(tex_coord_buf_.get());
-  // The line below attaches the vertex buffer to the VAO.
-  GL_CHECK(glVertexAttribPointer(attr_idx, 2, GL_FLOAT, GL_FALSE, 0, 0));
-  GL_CHECK(glEnableVertexAttribArray(attr_idx));
+  LinkBuffer(tex_coord_buf_.get(), attr_idx, 2, tex_coord_attr_idx_);
 }
 
 void VertexArray::SetDrawMode(DrawMode mode) {
@@ -134,19 +182,16 @@ void VertexArray::SetPolygonMode(PolygonMode mode) {
   polygon_mode_ = mode;
 }
 
-void VertexArray::Render(size_t start_index, size_t num_indices) const {
-  // WARNING: need to declare stack variables before RAII
-  // to avoid alignment issues.
-
-  BindGuard vao_bg(this);
+void VertexArray::SetCullMode(CullMode mode) {
+  cull_mode_ = mode;
+}
 
-  if (polygon_mode_ == PolygonMode::Wireframe) {
-    GL_CHECK(glPolygonMode(GL_FRONT_AND_BACK, GL_LINE));
-  } else {
-    GL_CHECK(glPolygonMode(GL_FRONT_AND_BACK, GL_FILL));
-  }
+void VertexArray::Render(size_t start_index, size_t num_indices) const {
+  // The vertex array stays bound, so consecutive draws of the same array don't rebind it.
+  Bind();
+  ApplyRasterModes(polygon_mode_, cull_mode_);
 
-  GLint draw_mode = draw_mode_ == DrawMode::Triangles ? GL_TRIANGLES : GL_LINES;
+  GLenum draw_mode = GetGLDrawMode(draw_mode_);
 
   if (idx_buf_ != nullptr) {
     GL_CHECK(glDrawElements(
@@ -157,6 +202,23 @@ void VertexArray::Render(size_t start_index, size_t num_indices) const {
   }
 }
 
+void VertexArray::Render(const std::vector<GLint>& firsts,
+                         const std::vector<GLsizei>& counts) const {
+  if (idx_buf_ != nullptr) {
+    throw std::runtime_error("Multi-range rendering doesn't support index buffers!");
+  }
+  if (firsts.empty()) {
+    return;
+  }
+
+  Bind();
+  ApplyRasterModes(polygon_mode_, cull_mode_);
+
+  GLenum draw_mode = GetGLDrawMode(draw_mode_);
+  GL_CHECK(glMultiDrawArrays(draw_mode, firsts.data(), counts.data(),
+                             static_cast<GLsizei>(firsts.size())));
+}
+
 void VertexArray::Render() const {
   if (idx_buf_ != nullptr)
     Render(0, idx_buf_->GetSize());
@@ -8,10 +8,21 @@
 #include "VertexBuffer.hpp"
 
 namespace GLOO {
-enum class DrawMode { Triangles, Lines };
+// TrianglesAdjacency expects 6 indices per triangle (see GL_TRIANGLES_ADJACENCY).
+enum class DrawMode { Triangles, Lines, TrianglesAdjacency };
 
 enum class PolygonMode { Wireframe, Fill };
 
+// Which faces are discarded when drawing triangles.
+enum class CullMode { None, Front, Back };
+
+// Attribute locations all shaders use for the vertex buffers (ShaderProgram binds the standard
+// attribute names to them before linking), so a vertex array linked for one shader works for all.
+const GLuint kPositionAttribLocation = 0;
+const GLuint kNormalAttribLocation = 1;
+const GLuint kTexCoordAttribLocation = 2;
+const GLuint kColorAttribLocation = 3;
+
 class VertexArray : public IBindable {
  public:
   VertexArray();
@@ -36,7 +47,11 @@ class VertexArray : public IBindable {
   void UpdateNormals(const NormalArray& normals) const;
   void UpdateColors(const ColorArray& colors) const;
   void UpdateTexCoords(const TexCoordArray& tex_coords) const;
-  void UpdateIndices(const IndexArray& indices) const;
+  void UpdateIndices(const IndexArray& indices, size_t first_changed = 0) const;
+  // Makes room for `count` indices that are written on the GPU (see VertexBuffer::Reserve).
+  void ReserveIndices(size_t count) const;
+  // Attaching a buffer to the attribute it's already attached to does nothing, so shaders can link
+  // before every draw.
   void LinkPositionBuffer(GLuint attr_idx) const;
   void LinkNormalBuffer(GLuint attr_idx) const;
   void LinkColorBuffer(GLuint attr_idx) const;
@@ -62,9 +77,26 @@ class VertexArray : public IBindable {
     return idx_buf_ != nullptr;
   }
 
+  // Handle of the position buffer, e.g. for viewing it as a texture buffer in shaders.
+  GLuint GetPositionBufferHandle() const {
+    return pos_buf_->GetHandle();
+  }
+  size_t GetPositionBufferSize() const {
+    return pos_buf_->GetSize();
+  }
+  unsigned int GetPositionBufferVersion() const {
+    return pos_buf_->GetVersion();
+  }
+  GLuint GetIndexBufferHandle() const {
+    return idx_buf_->GetHandle();
+  }
+
   void SetDrawMode(DrawMode mode);
   void SetPolygonMode(PolygonMode mode);
+  void SetCullMode(CullMode mode);
   void Render(size_t start_index, size_t num_indices) const;
+  // Draws several vertex ranges in one call (glMultiDrawArrays, index buffers aren't supported).
+  void Render(const std::vector<GLint>& firsts, const std::vector<GLsizei>& counts) const;
   void Render() const;
 
  private:
@@ -81,8 +113,18 @@ class VertexArray : public IBindable {
   std::unique_ptr<TexCoordBuffer> tex_coord_buf_;
   std::unique_ptr<IndexBuffer> idx_buf_;
 
+  void LinkBuffer(const IBindable* buffer, GLuint attr_idx, GLint num_components,
+                  GLint& linked_attr_idx) const;
+
+  // Attribute each buffer is attached to, or -1 if it isn't attached yet.
+  mutable GLint pos_attr_idx_{-1};
+  mutable GLint normal_attr_idx_{-1};
+  mutable GLint color_attr_idx_{-1};
+  mutable GLint tex_coord_attr_idx_{-1};
+
   DrawMode draw_mode_;
   PolygonMode polygon_mode_;
+  CullMode cull_mode_;
   GLuint handle_{GLuint(-1)};
 };
 }  // namespace GLOO
@@ -3,6 +3,7 @@
 
 #include "BindableBuffer.hpp"
 
+#include <algorithm>
 #include <vector>
 
 #include <glad/glad.h>
@@ -15,13 +16,28 @@ template <class T, GLenum target>
 class VertexBuffer : public BindableBuffer {
  public:
   VertexBuffer(GLenum usage);
-  void Update(const std::vector<T>& array);
+  // Uploads `array`. Elements before `first_changed` are assumed to be unchanged since the last
+  // update and are skipped when the buffer doesn't need to grow.
+  void Update(const std::vector<T>& array, size_t first_changed = 0);
+  // Grows the GPU storage to hold at least `count` elements without uploading anything, for
+  // buffers written by the GPU. Growing discards the current contents.
+  void Reserve(size_t count);
   size_t GetSize() const {
     return size_;
   }
+  // Number of elements the GPU storage can hold without being reallocated.
+  size_t GetCapacity() const {
+    return capacity_;
+  }
+  // Incremented on every update, so users of the buffer contents can tell when they changed.
+  unsigned int GetVersion() const {
+    return version_;
+  }
 
  private:
-  size_t size_;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+  unsigned int version_ = 0;
   GLenum usage_;
 };
 
@@ -31,11 +47,34 @@ VertexBuffer<T, target>::VertexBuffer(GLenum usage)
 }
 
 template <class T, GLenum target>
-void VertexBuffer<T, target>::Update(const std::vector<T>& array) {
+void VertexBuffer<T, target>::Update(const std::vector<T>& array, size_t first_changed) {
   BindGuard bg(this);
-  GL_CHECK(
-      glBufferData(target_, sizeof(T) * array.size(), array.data(), usage_));
+  if (array.size() > capacity_) {
+    first_changed = 0;
+    // Grow geometrically when resizing an existing buffer, so data that is rebuilt every frame
+    // (e.g. outline indices and polylines) settles on a fixed allocation.
+    capacity_ = capacity_ == 0 ? array.size() : std::max(array.size(), capacity_ + capacity_ / 2);
+    GL_CHECK(glBufferData(target_, sizeof(T) * capacity_, nullptr, usage_));
+  }
+  if (array.size() > first_changed) {
+    GL_CHECK(glBufferSubData(target_, sizeof(T) * first_changed,
+                             sizeof(T) * (array.size() - first_changed),
+                             array.data() + first_changed));
+  }
   size_ = array.size();
+  version_++;
+}
+
+template <class T, GLenum target>
+void VertexBuffer<T, target>::Reserve(size_t count) {
+  if (count <= capacity_) {
+    return;
+  }
+  BindGuard bg(this);
+  capacity_ = count;
+  GL_CHECK(glBufferData(target_, sizeof(T) * capacity_, nullptr, usage_));
+  size_ = 0;
+  version_++;
 }
 }  // namespace GLOO
 
@@ -0,0 +1,15 @@
+#include "CameraBlock.hpp"
+
+#include <glm/matrix.hpp>
+
+#include "gloo/components/CameraComponent.hpp"
+
+namespace GLOO {
+void PackCamera(const CameraComponent& camera, CameraBlock& block) {
+  block = CameraBlock();
+  block.view_matrix = camera.GetViewMatrix();
+  block.projection_matrix = camera.GetProjectionMatrix();
+  block.camera_position =
+      glm::vec3(glm::inverse(block.view_matrix) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+}
+}  // namespace GLOO
@@ -0,0 +1,27 @@
+#ifndef GLOO_CAMERA_BLOCK_H_
+#define GLOO_CAMERA_BLOCK_H_
+
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+namespace GLOO {
+class CameraComponent;
+
+// View of the active camera, mirroring the std140 `CameraBlock` uniform block declared by the
+// vertex shaders of the lit and normal/depth shaders. The renderer uploads it once per frame (if
+// the camera moved) and binds it to kCameraBlockBinding.
+const GLuint kCameraBlockBinding = 1;
+
+struct CameraBlock {
+  glm::mat4 view_matrix;
+  glm::mat4 projection_matrix;
+  glm::vec3 camera_position;  // world space
+  float padding;
+};
+static_assert(sizeof(CameraBlock) == 2 * 64 + 16,
+              "CameraBlock must match the std140 layout of the GLSL block");
+
+void PackCamera(const CameraComponent& camera, CameraBlock& block);
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,55 @@
+#include "DeferredLightingShader.hpp"
+
+#include <glm/matrix.hpp>
+#include <stdexcept>
+
+#include "gloo/components/CameraComponent.hpp"
+#include "gloo/shaders/LightBlock.hpp"
+
+namespace GLOO {
+DeferredLightingShader::DeferredLightingShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>{
+          {GL_VERTEX_SHADER, "plain_texture.vert"},
+          {GL_FRAGMENT_SHADER, "deferred_lighting.frag"}}) {
+  BindUniformBlock("LightBlock", kLightBlockBinding);
+}
+
+void DeferredLightingShader::AssociateVertexArray(const VertexArray& vertex_array) const {
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("Deferred lighting shader requires vertex positions!");
+  }
+  if (!vertex_array.HasTexCoordBuffer()) {
+    throw std::runtime_error("Deferred lighting shader requires vertex texture coordinates!");
+  }
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+  vertex_array.LinkTexCoordBuffer(kTexCoordAttribLocation);
+}
+
+void DeferredLightingShader::SetVertexObject(const VertexObject& obj) const {
+  AssociateVertexArray(obj.GetVertexArray());
+}
+
+void DeferredLightingShader::SetCamera(const CameraComponent& camera) const {
+  glm::mat4 view_to_world_matrix = glm::inverse(camera.GetViewMatrix());
+  SetUniform("inverse_projection_matrix", glm::inverse(camera.GetProjectionMatrix()));
+  SetUniform("view_to_world_matrix", view_to_world_matrix);
+  SetUniform("camera_position", glm::vec3(view_to_world_matrix[3]));
+}
+
+void DeferredLightingShader::SetGBuffer(const Texture& normal_depth_texture,
+                                        const Texture& low_color_texture,
+                                        const Texture& high_color_texture,
+                                        const Texture& material_texture,
+                                        const Texture& depth_texture) const {
+  normal_depth_texture.BindToUnit(0);
+  SetUniform("normal_depth_texture", 0);
+  low_color_texture.BindToUnit(1);
+  SetUniform("low_color_texture", 1);
+  high_color_texture.BindToUnit(2);
+  SetUniform("high_color_texture", 2);
+  material_texture.BindToUnit(3);
+  SetUniform("material_texture", 3);
+  depth_texture.BindToUnit(4);
+  SetUniform("depth_texture", 4);
+}
+}  // namespace GLOO
@@ -0,0 +1,31 @@
+#ifndef GLOO_DEFERRED_LIGHTING_SHADER_H_
+#define GLOO_DEFERRED_LIGHTING_SHADER_H_
+
+#include "ShaderProgram.hpp"
+
+#include "gloo/VertexObject.hpp"
+#include "gloo/gl_wrapper/Texture.hpp"
+
+namespace GLOO {
+/**
+ * Full screen shader applying the lights of the light block to the G-buffer written by
+ * GBufferShader, with the tone mapping or toon equation each pixel asks for. Pixels without a
+ * surface are discarded, and the G-buffer depth is written so forward passes can depth test
+ * against it.
+ */
+class DeferredLightingShader : public ShaderProgram {
+ public:
+  DeferredLightingShader();
+
+  void SetVertexObject(const VertexObject& obj) const;
+  void SetCamera(const CameraComponent& camera) const override;
+  void SetGBuffer(const Texture& normal_depth_texture, const Texture& low_color_texture,
+                  const Texture& high_color_texture, const Texture& material_texture,
+                  const Texture& depth_texture) const;
+
+ private:
+  void AssociateVertexArray(const VertexArray& vertex_array) const;
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,175 @@
+#include "EdgeCompactionShader.hpp"
+
+#include <stdexcept>
+
+#include "gloo/gl_wrapper/BindGuard.hpp"
+
+namespace {
+const char* kEdgeDataNames[] = {"edge_vertices", "edge_faces", "edge_types", "face_planes"};
+const GLenum kEdgeDataFormats[] = {GL_RG32UI, GL_RG32UI, GL_R8UI, GL_RGBA32F};
+}  // namespace
+
+namespace GLOO {
+EdgeCompactionShader::EdgeCompactionShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>{{GL_VERTEX_SHADER,
+                                                             "edge_compaction.vert"},
+                                                            {GL_GEOMETRY_SHADER,
+                                                             "edge_compaction.geom"}},
+                    {"edge_indices"}) {
+  GL_CHECK(glGenBuffers(kNumEdgeData, edge_data_buffers_));
+  GL_CHECK(glGenTextures(kNumEdgeData, edge_data_textures_));
+  for (auto& slot : result_slots_) {
+    GL_CHECK(glGenBuffers(1, &slot.buffer));
+    GL_CHECK(glGenQueries(1, &slot.query));
+  }
+}
+
+EdgeCompactionShader::~EdgeCompactionShader() {
+  for (auto& slot : result_slots_) {
+    glDeleteQueries(1, &slot.query);
+    glDeleteBuffers(1, &slot.buffer);
+  }
+  glDeleteTextures(kNumEdgeData, edge_data_textures_);
+  glDeleteBuffers(kNumEdgeData, edge_data_buffers_);
+}
+
+void EdgeCompactionShader::SetEdges(const std::vector<uint32_t>& edge_vertices,
+                                    const std::vector<uint32_t>& edge_faces,
+                                    const std::vector<uint8_t>& edge_types,
+                                    const std::vector<glm::vec4>& face_planes) {
+  num_edges_ = edge_types.size();
+  if (edge_vertices.size() != 2 * num_edges_ || edge_faces.size() != 2 * num_edges_) {
+    throw std::runtime_error("Edge compaction needs 2 vertices and 2 faces per edge!");
+  }
+  const void* data[] = {edge_vertices.data(), edge_faces.data(), edge_types.data(),
+                        face_planes.data()};
+  size_t sizes[] = {sizeof(uint32_t) * edge_vertices.size(), sizeof(uint32_t) * edge_faces.size(),
+                    sizeof(uint8_t) * edge_types.size(), sizeof(glm::vec4) * face_planes.size()};
+  for (int i = 0; i < kNumEdgeData; i++) {
+    GL_CHECK(glBindBuffer(GL_TEXTURE_BUFFER, edge_data_buffers_[i]));
+    GL_CHECK(glBufferData(GL_TEXTURE_BUFFER, sizes[i], data[i], GL_STATIC_DRAW));
+    GL_CHECK(glBindTexture(GL_TEXTURE_BUFFER, edge_data_textures_[i]));
+    GL_CHECK(glTexBuffer(GL_TEXTURE_BUFFER, kEdgeDataFormats[i], edge_data_buffers_[i]));
+  }
+  GL_CHECK(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+  // Passes over the old edges must not be drawn with the new ones
+  for (auto& slot : result_slots_) {
+    slot.request_id = 0;
+  }
+}
+
+void EdgeCompactionShader::Compact(const glm::vec3& eye_position, float cos_crease_threshold,
+                                   int shown_types) {
+  last_request_id_++;
+  if (num_edges_ == 0 || shown_types == 0) {
+    has_request_ = false;
+    empty_request_id_ = last_request_id_;
+    return;
+  }
+  // Only the latest request matters, so a newer one replaces one still waiting for a slot.
+  request_eye_position_ = eye_position;
+  request_cos_crease_threshold_ = cos_crease_threshold;
+  request_shown_types_ = shown_types;
+  has_request_ = true;
+  SubmitRequest();
+}
+
+void EdgeCompactionShader::SubmitRequest() {
+  if (!has_request_) {
+    return;
+  }
+  ResultSlot* slot = nullptr;
+  for (auto& candidate : result_slots_) {
+    if (!candidate.in_flight) {
+      slot = &candidate;
+      break;
+    }
+  }
+  if (slot == nullptr) {
+    // The GPU is still busy with earlier passes, try again on the next fetch
+    return;
+  }
+  if (slot->capacity < num_edges_) {
+    slot->capacity = num_edges_;
+    GL_CHECK(glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, slot->buffer));
+    GL_CHECK(glBufferData(GL_TRANSFORM_FEEDBACK_BUFFER, 2 * sizeof(uint32_t) * slot->capacity,
+                          nullptr, GL_DYNAMIC_COPY));
+    GL_CHECK(glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0));
+  }
+
+  BindGuard shader_bg(this);
+  for (int i = 0; i < kNumEdgeData; i++) {
+    GL_CHECK(glActiveTexture(GL_TEXTURE0 + i));
+    GL_CHECK(glBindTexture(GL_TEXTURE_BUFFER, edge_data_textures_[i]));
+    SetUniform(kEdgeDataNames[i], i);
+  }
+  SetUniform("eye_position", request_eye_position_);
+  SetUniform("cos_crease_threshold", request_cos_crease_threshold_);
+  SetUniform("shown_types", request_shown_types_);
+
+  BindGuard vao_bg(&empty_vertex_array_);
+  // Only the captured indices are needed, nothing is rasterized.
+  GL_CHECK(glEnable(GL_RASTERIZER_DISCARD));
+  GL_CHECK(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, slot->buffer));
+  GL_CHECK(glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, slot->query));
+  GL_CHECK(glBeginTransformFeedback(GL_POINTS));
+  GL_CHECK(glDrawArrays(GL_POINTS, 0, (GLsizei)num_edges_));
+  GL_CHECK(glEndTransformFeedback());
+  GL_CHECK(glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN));
+  GL_CHECK(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0));
+  GL_CHECK(glDisable(GL_RASTERIZER_DISCARD));
+
+  slot->in_flight = true;
+  slot->request_id = last_request_id_;
+  has_request_ = false;
+}
+
+bool EdgeCompactionShader::FetchResult(GLuint output_buffer, size_t& num_edges) {
+  // Passes finish in submission order, so check the oldest first and stop at the first one that
+  // isn't done. Never ask for GL_QUERY_RESULT before it's available, that would wait for the GPU.
+  bool fetched = false;
+  while (true) {
+    ResultSlot* oldest = nullptr;
+    for (auto& slot : result_slots_) {
+      if (slot.in_flight && (oldest == nullptr || slot.request_id < oldest->request_id)) {
+        oldest = &slot;
+      }
+    }
+    if (oldest == nullptr) {
+      break;
+    }
+    GLuint available = 0;
+    GL_CHECK(glGetQueryObjectuiv(oldest->query, GL_QUERY_RESULT_AVAILABLE, &available));
+    if (!available) {
+      break;
+    }
+    oldest->in_flight = false;
+    if (oldest->request_id <= fetched_request_id_) {
+      continue;  // stale, or older than a result that's already drawn
+    }
+    GLuint num_written = 0;
+    GL_CHECK(glGetQueryObjectuiv(oldest->query, GL_QUERY_RESULT, &num_written));
+    // Copy on the GPU into the buffer that's drawn, which keeps its previous edges until now.
+    GL_CHECK(glBindBuffer(GL_COPY_READ_BUFFER, oldest->buffer));
+    GL_CHECK(glBindBuffer(GL_COPY_WRITE_BUFFER, output_buffer));
+    GL_CHECK(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                                 2 * sizeof(uint32_t) * num_written));
+    GL_CHECK(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+    GL_CHECK(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+    num_edges = num_written;
+    fetched_request_id_ = oldest->request_id;
+    fetched = true;
+  }
+  if (empty_request_id_ > fetched_request_id_) {
+    num_edges = 0;
+    fetched_request_id_ = empty_request_id_;
+    fetched = true;
+  }
+  SubmitRequest();
+  return fetched;
+}
+
+bool EdgeCompactionShader::HasPendingResult() const {
+  return fetched_request_id_ < last_request_id_;
+}
+}  // namespace GLOO
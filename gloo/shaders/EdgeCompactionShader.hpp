@@ -0,0 +1,93 @@
+#ifndef GLOO_EDGE_COMPACTION_SHADER_H
+#define GLOO_EDGE_COMPACTION_SHADER_H
+
+#include "ShaderProgram.hpp"
+
+namespace GLOO {
+/**
+ * Transform feedback shader that classifies the edges of a mesh on the GPU and writes the vertex
+ * index pairs of the visible ones into an index buffer, so line outlines can be drawn without
+ * uploading indices from the CPU.
+ *
+ * Edge data is static and uploaded once with SetEdges. Each edge has a type mask of the types it
+ * can take, using the bits silhouette = 1, crease = 2 and border = 4: border edges are always
+ * borders, and edges with two faces are silhouettes or creases depending on the camera and the
+ * crease threshold.
+ *
+ * The number of edges written is only known on the GPU, and GL 3.3 can't source an indexed draw's
+ * count from a buffer. Reading it back right away would stall until the pass finishes, so each
+ * pass writes into one of two result slots with its own query, and FetchResult() copies the newest
+ * finished one to the draw's index buffer once its query result is available, typically a frame
+ * later.
+ */
+class EdgeCompactionShader : public ShaderProgram {
+ public:
+  EdgeCompactionShader();
+  ~EdgeCompactionShader();
+
+  /**
+   * Uploads the static edge data.
+   *
+   * @param edge_vertices 2 vertex indices per edge.
+   * @param edge_faces 2 face ids per edge, only read for edges that can be silhouettes or creases.
+   * @param edge_types Type mask of each edge.
+   * @param face_planes Per face (normal, -dot(normal, point on face)), so a face is front facing
+   * when dot(plane, (eye, 1)) >= 0.
+   */
+  void SetEdges(const std::vector<uint32_t>& edge_vertices, const std::vector<uint32_t>& edge_faces,
+                const std::vector<uint8_t>& edge_types, const std::vector<glm::vec4>& face_planes);
+
+  /**
+   * Requests the vertex index pairs of the edges whose types intersect `shown_types`. The pass
+   * runs as soon as a result slot is free, and its result is picked up by FetchResult().
+   *
+   * @param eye_position Camera position in the object space of the edges.
+   * @param cos_crease_threshold Edges whose faces' normals have a smaller dot product are creases.
+   */
+  void Compact(const glm::vec3& eye_position, float cos_crease_threshold, int shown_types);
+
+  /**
+   * Copies the edges of the newest finished pass that wasn't fetched yet into `output_buffer`,
+   * which must hold 2 indices per edge, and sets `num_edges` to their count. Returns false (and
+   * leaves both alone) if no newer result is ready. Never waits for the GPU.
+   */
+  bool FetchResult(GLuint output_buffer, size_t& num_edges);
+  // Whether a requested result hasn't been fetched yet, i.e. FetchResult() should be called again.
+  bool HasPendingResult() const;
+
+ private:
+  // Buffers of static edge data and the texture buffers viewing them, in the order of
+  // kEdgeDataNames in the source file
+  static const int kNumEdgeData = 4;
+  GLuint edge_data_buffers_[kNumEdgeData];
+  GLuint edge_data_textures_[kNumEdgeData];
+  size_t num_edges_ = 0;
+
+  // Output of one pass, counted by its query
+  struct ResultSlot {
+    GLuint buffer = 0;
+    size_t capacity = 0;  // in edges
+    GLuint query = 0;
+    bool in_flight = false;
+    unsigned int request_id = 0;  // 0 if the result is stale
+  };
+  static const int kNumResultSlots = 2;
+  ResultSlot result_slots_[kNumResultSlots];
+  void SubmitRequest();
+
+  // Latest request, waiting for a free slot if `has_request_`
+  glm::vec3 request_eye_position_;
+  float request_cos_crease_threshold_ = 0;
+  int request_shown_types_ = 0;
+  bool has_request_ = false;
+  unsigned int last_request_id_ = 0;
+  // Request known to produce no edges without running a pass
+  unsigned int empty_request_id_ = 0;
+  // Request whose result is in the output buffer
+  unsigned int fetched_request_id_ = 0;
+  // No vertex attributes are read, but core profiles need a vertex array bound to draw
+  VertexArray empty_vertex_array_;
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,46 @@
+#include "EdgeDetectionShader.hpp"
+
+#include <stdexcept>
+
+namespace GLOO {
+EdgeDetectionShader::EdgeDetectionShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>{
+          {GL_VERTEX_SHADER, "plain_texture.vert"}, {GL_FRAGMENT_SHADER, "edge_detection.frag"}}) {
+}
+
+void EdgeDetectionShader::AssociateVertexArray(const VertexArray& vertex_array) const {
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("Edge detection shader requires vertex positions!");
+  }
+  if (!vertex_array.HasTexCoordBuffer()) {
+    throw std::runtime_error("Edge detection shader requires vertex texture coordinates!");
+  }
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+  vertex_array.LinkTexCoordBuffer(kTexCoordAttribLocation);
+}
+
+void EdgeDetectionShader::SetVertexObject(const VertexObject& obj) const {
+  AssociateVertexArray(obj.GetVertexArray());
+}
+
+void EdgeDetectionShader::SetNormalDepthTexture(const Texture& texture,
+                                                const glm::ivec2& size) const {
+  texture.BindToUnit(0);
+  SetUniform("normal_depth_texture", 0);
+  SetUniform("u_texelSize", glm::vec2(1.0f / size.x, 1.0f / size.y));
+}
+
+void EdgeDetectionShader::SetOutlineStyle(const glm::vec3& color, float thickness,
+                                          bool depth_edges, bool normal_edges,
+                                          float cos_crease_threshold) const {
+  SetUniform("outline_color", color);
+  SetUniform("u_thickness", thickness);
+  SetUniform("depth_edges", depth_edges);
+  SetUniform("normal_edges", normal_edges);
+  SetUniform("cos_crease_threshold", cos_crease_threshold);
+}
+
+void EdgeDetectionShader::SetSeedOutput(bool enabled) const {
+  SetUniform("write_seeds", enabled);
+}
+}  // namespace GLOO
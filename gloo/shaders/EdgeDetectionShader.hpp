@@ -0,0 +1,39 @@
+#ifndef GLOO_EDGE_DETECTION_SHADER_H_
+#define GLOO_EDGE_DETECTION_SHADER_H_
+
+#include "ShaderProgram.hpp"
+
+#include "gloo/VertexObject.hpp"
+#include "gloo/gl_wrapper/Texture.hpp"
+
+namespace GLOO {
+/**
+ * Full screen shader drawing outlines where the output of NormalDepthShader is discontinuous.
+ *
+ * Each pixel compares the diagonal neighbors (Roberts cross) half the outline thickness away, so
+ * lines come out roughly as thick as requested at a fixed cost per pixel. Pixels without an
+ * outline are discarded, so the pass can be blended over the shaded scene.
+ */
+class EdgeDetectionShader : public ShaderProgram {
+ public:
+  EdgeDetectionShader();
+
+  void SetVertexObject(const VertexObject& obj) const;
+  void SetNormalDepthTexture(const Texture& texture, const glm::ivec2& size) const;
+  /**
+   * @param depth_edges Draw depth discontinuities (silhouettes).
+   * @param normal_edges Draw normal discontinuities, where the normals' dot product is below
+   * `cos_crease_threshold` (creases).
+   */
+  void SetOutlineStyle(const glm::vec3& color, float thickness, bool depth_edges, bool normal_edges,
+                       float cos_crease_threshold) const;
+  // Writes the window coordinates of edge pixels instead of the outline color, to seed
+  // JumpFloodShader.
+  void SetSeedOutput(bool enabled) const;
+
+ private:
+  void AssociateVertexArray(const VertexArray& vertex_array) const;
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,48 @@
+#include "GBufferShader.hpp"
+
+#include <glm/matrix.hpp>
+#include <stdexcept>
+
+#include "gloo/SceneNode.hpp"
+#include "gloo/components/RenderingComponent.hpp"
+#include "gloo/shaders/CameraBlock.hpp"
+#include "gloo/shaders/MaterialBlock.hpp"
+
+namespace GLOO {
+GBufferShader::GBufferShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>{
+          {GL_VERTEX_SHADER, "normal_depth.vert"}, {GL_FRAGMENT_SHADER, "g_buffer.frag"}}) {
+  BindUniformBlock("CameraBlock", kCameraBlockBinding);
+  BindUniformBlock("MaterialBlock", kMaterialBlockBinding);
+  model_matrix_ = GetUniform<glm::mat4>("model_matrix");
+  normal_matrix_ = GetUniform<glm::mat3>("normal_matrix");
+  shading_model_ = GetUniform<int>("shading_model");
+}
+
+void GBufferShader::AssociateVertexArray(VertexArray& vertex_array) const {
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("G-buffer shader requires vertex positions!");
+  }
+  if (!vertex_array.HasNormalBuffer()) {
+    throw std::runtime_error("G-buffer shader requires vertex normals!");
+  }
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+  vertex_array.LinkNormalBuffer(kNormalAttribLocation);
+}
+
+void GBufferShader::SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const {
+  // Associate the right VAO before rendering.
+  AssociateVertexArray(
+      node.GetComponentPtr<RenderingComponent>()->GetVertexObjectPtr()->GetVertexArray());
+
+  // Set transform.
+  glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(model_matrix)));
+  SetUniform(model_matrix_, model_matrix);
+  SetUniform(normal_matrix_, normal_matrix);
+  // The camera and material are read from the uniform blocks the renderer uploads.
+}
+
+void GBufferShader::SetShadingModel(DeferredShadingModel model) const {
+  SetUniform(shading_model_, static_cast<int>(model));
+}
+}  // namespace GLOO
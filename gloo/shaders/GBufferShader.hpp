@@ -0,0 +1,27 @@
+#ifndef GLOO_G_BUFFER_SHADER_H_
+#define GLOO_G_BUFFER_SHADER_H_
+
+#include "ShaderProgram.hpp"
+
+namespace GLOO {
+/**
+ * Rasterizes surfaces into the G-buffer of deferred rendering: view space normal and depth (laid
+ * out like NormalDepthShader's output, so screen space outlines can reuse it), the NPR material's
+ * low/high colors and intensities, and the lighting equation to shade the surface with.
+ */
+class GBufferShader : public ShaderProgram {
+ public:
+  GBufferShader();
+  void SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const override;
+  void SetShadingModel(DeferredShadingModel model) const;
+
+ private:
+  void AssociateVertexArray(VertexArray& vertex_array) const;
+
+  UniformHandle<glm::mat4> model_matrix_;
+  UniformHandle<glm::mat3> normal_matrix_;
+  UniformHandle<int> shading_model_;
+};
+}  // namespace GLOO
+
+#endif
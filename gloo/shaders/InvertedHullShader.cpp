@@ -0,0 +1,67 @@
+#include "InvertedHullShader.hpp"
+
+#include <glm/matrix.hpp>
+#include <stdexcept>
+
+#include "gloo/InputManager.hpp"
+#include "gloo/SceneNode.hpp"
+#include "gloo/components/CameraComponent.hpp"
+#include "gloo/components/MaterialComponent.hpp"
+#include "gloo/components/RenderingComponent.hpp"
+#include "gloo/shaders/CameraBlock.hpp"
+
+namespace GLOO {
+InvertedHullShader::InvertedHullShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>{
+          {GL_VERTEX_SHADER, "inverted_hull.vert"}, {GL_FRAGMENT_SHADER, "outline.frag"}}) {
+  BindUniformBlock("CameraBlock", kCameraBlockBinding);
+  model_matrix_ = GetUniform<glm::mat4>("model_matrix");
+  normal_matrix_ = GetUniform<glm::mat3>("normal_matrix");
+  material_color_ = GetUniform<glm::vec3>("material_color");
+  thickness_ = GetUniform<float>("u_thickness");
+}
+
+void InvertedHullShader::AssociateVertexArray(VertexArray& vertex_array) const {
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("Inverted hull shader requires vertex positions!");
+  }
+  if (!vertex_array.HasNormalBuffer()) {
+    throw std::runtime_error("Inverted hull shader requires vertex normals!");
+  }
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+  vertex_array.LinkNormalBuffer(kNormalAttribLocation);
+}
+
+void InvertedHullShader::SetTargetNode(const SceneNode& node,
+                                       const glm::mat4& model_matrix) const {
+  // Associate the right VAO before rendering.
+  AssociateVertexArray(
+      node.GetComponentPtr<RenderingComponent>()->GetVertexObjectPtr()->GetVertexArray());
+
+  // Set transform.
+  glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(model_matrix)));
+  SetUniform(model_matrix_, model_matrix);
+  SetUniform(normal_matrix_, normal_matrix);
+
+  // Set material.
+  MaterialComponent* material_component_ptr = node.GetComponentPtr<MaterialComponent>();
+  const Material* material_ptr;
+  if (material_component_ptr == nullptr) {
+    material_ptr = &Material::GetDefaultNPR();
+  } else {
+    material_ptr = &material_component_ptr->GetMaterial();
+  }
+
+  SetUniform(material_color_, material_ptr->GetOutlineColor());
+  SetUniform(thickness_, material_ptr->GetOutlineThickness());
+}
+
+void InvertedHullShader::SetCamera(const CameraComponent& camera) const {
+  // Update shader using window size
+  glm::ivec2 window_size = InputManager::GetInstance().GetWindowSize();
+  glm::vec2 inverse_window_size = glm::vec2(1. / window_size.x, 1. / window_size.y);
+  SetUniform("u_viewportInvSize", inverse_window_size);
+
+  // The view and projection are read from the camera block the renderer uploads.
+}
+}  // namespace GLOO
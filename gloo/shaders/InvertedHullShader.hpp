@@ -0,0 +1,30 @@
+#ifndef GLOO_INVERTED_HULL_SHADER_H
+#define GLOO_INVERTED_HULL_SHADER_H
+
+#include "ShaderProgram.hpp"
+
+namespace GLOO {
+/**
+ * Shader for inverted hull outlines: the mesh is drawn again with front faces culled, and every
+ * vertex is pushed out along its normal by the outline thickness in screen space. The back faces
+ * that stick out from behind the mesh form its outline, without any edge extraction.
+ *
+ * Meshes need vertex normals, and their rendering component should cull front faces.
+ */
+class InvertedHullShader : public ShaderProgram {
+ public:
+  InvertedHullShader();
+  void SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const override;
+  void SetCamera(const CameraComponent& camera) const override;
+
+ private:
+  void AssociateVertexArray(VertexArray& vertex_array) const;
+
+  UniformHandle<glm::mat4> model_matrix_;
+  UniformHandle<glm::mat3> normal_matrix_;
+  UniformHandle<glm::vec3> material_color_;
+  UniformHandle<float> thickness_;
+};
+}  // namespace GLOO
+
+#endif
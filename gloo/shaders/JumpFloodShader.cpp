@@ -0,0 +1,57 @@
+#include "JumpFloodShader.hpp"
+
+#include <stdexcept>
+
+namespace GLOO {
+JumpFloodShader::JumpFloodShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>{
+          {GL_VERTEX_SHADER, "plain_texture.vert"}, {GL_FRAGMENT_SHADER, "jump_flood.frag"}}) {
+}
+
+void JumpFloodShader::AssociateVertexArray(const VertexArray& vertex_array) const {
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("Jump flood shader requires vertex positions!");
+  }
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+}
+
+void JumpFloodShader::SetVertexObject(const VertexObject& obj) const {
+  AssociateVertexArray(obj.GetVertexArray());
+}
+
+void JumpFloodShader::SetSeedTexture(const Texture& texture) const {
+  texture.BindToUnit(0);
+  SetUniform("seed_texture", 0);
+}
+
+void JumpFloodShader::SetStep(int step) const {
+  SetUniform("u_step", step);
+}
+
+DistanceOutlineShader::DistanceOutlineShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>{
+          {GL_VERTEX_SHADER, "plain_texture.vert"},
+          {GL_FRAGMENT_SHADER, "distance_outline.frag"}}) {
+}
+
+void DistanceOutlineShader::AssociateVertexArray(const VertexArray& vertex_array) const {
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("Distance outline shader requires vertex positions!");
+  }
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+}
+
+void DistanceOutlineShader::SetVertexObject(const VertexObject& obj) const {
+  AssociateVertexArray(obj.GetVertexArray());
+}
+
+void DistanceOutlineShader::SetSeedTexture(const Texture& texture) const {
+  texture.BindToUnit(0);
+  SetUniform("seed_texture", 0);
+}
+
+void DistanceOutlineShader::SetOutlineStyle(const glm::vec3& color, float thickness) const {
+  SetUniform("outline_color", color);
+  SetUniform("u_thickness", thickness);
+}
+}  // namespace GLOO
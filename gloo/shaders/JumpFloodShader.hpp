@@ -0,0 +1,42 @@
+#ifndef GLOO_JUMP_FLOOD_SHADER_H_
+#define GLOO_JUMP_FLOOD_SHADER_H_
+
+#include "ShaderProgram.hpp"
+
+#include "gloo/VertexObject.hpp"
+#include "gloo/gl_wrapper/Texture.hpp"
+
+namespace GLOO {
+/**
+ * Full screen jump flooding pass. Seed textures store, per pixel, the window coordinates of the
+ * nearest seed found so far (negative where none was found). Each pass looks at the 3x3 pixels
+ * `step` pixels apart and keeps the nearest of their seeds, so halving the step from the largest
+ * distance of interest down to 1 approximates the distance transform in log2(distance) passes.
+ */
+class JumpFloodShader : public ShaderProgram {
+ public:
+  JumpFloodShader();
+
+  void SetVertexObject(const VertexObject& obj) const;
+  void SetSeedTexture(const Texture& texture) const;
+  void SetStep(int step) const;
+
+ private:
+  void AssociateVertexArray(const VertexArray& vertex_array) const;
+};
+
+// Full screen shader drawing a rounded outline over the pixels within `thickness` / 2 of a seed.
+class DistanceOutlineShader : public ShaderProgram {
+ public:
+  DistanceOutlineShader();
+
+  void SetVertexObject(const VertexObject& obj) const;
+  void SetSeedTexture(const Texture& texture) const;
+  void SetOutlineStyle(const glm::vec3& color, float thickness) const;
+
+ private:
+  void AssociateVertexArray(const VertexArray& vertex_array) const;
+};
+}  // namespace GLOO
+
+#endif
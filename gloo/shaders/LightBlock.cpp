@@ -0,0 +1,80 @@
+#include "LightBlock.hpp"
+
+#include <stdexcept>
+
+#include "gloo/SceneNode.hpp"
+#include "gloo/components/LightComponent.hpp"
+#include "gloo/lights/AmbientLight.hpp"
+#include "gloo/lights/DirectionalLight.hpp"
+#include "gloo/lights/PointLight.hpp"
+#include "ShaderProgram.hpp"
+
+namespace GLOO {
+void PackLight(const LightComponent& component, bool uses_shadow_map, LightBlockEntry& entry) {
+  auto light_ptr = component.GetLightPtr();
+  if (light_ptr == nullptr) {
+    throw std::runtime_error("Light component has no light attached!");
+  }
+
+  entry = LightBlockEntry();
+  entry.info = glm::ivec4(static_cast<int>(light_ptr->GetType()), uses_shadow_map ? 1 : 0, 0, 0);
+  if (light_ptr->GetType() == LightType::Ambient) {
+    auto ambient_light_ptr = static_cast<AmbientLight*>(light_ptr);
+    entry.diffuse = glm::vec4(ambient_light_ptr->GetAmbientColor(), 0.0f);
+  } else if (light_ptr->GetType() == LightType::Point) {
+    auto point_light_ptr = static_cast<PointLight*>(light_ptr);
+    entry.position = glm::vec4(component.GetNodePtr()->GetTransform().GetPosition(), 1.0f);
+    entry.diffuse = glm::vec4(point_light_ptr->GetDiffuseColor(), 0.0f);
+    entry.specular = glm::vec4(point_light_ptr->GetSpecularColor(), 0.0f);
+    entry.attenuation = glm::vec4(point_light_ptr->GetAttenuation(), 0.0f);
+  } else if (light_ptr->GetType() == LightType::Directional) {
+    auto directional_light_ptr = static_cast<DirectionalLight*>(light_ptr);
+    entry.direction = glm::vec4(directional_light_ptr->GetDirection(), 0.0f);
+    entry.diffuse = glm::vec4(directional_light_ptr->GetDiffuseColor(), 0.0f);
+    entry.specular = glm::vec4(directional_light_ptr->GetSpecularColor(), 0.0f);
+  } else {
+    throw std::runtime_error("Encountered light type unrecognized by the shader!");
+  }
+}
+
+LightComponent* PackLights(const std::vector<LightComponent*>& lights, size_t first, size_t end,
+                           LightBlock& block) {
+  LightComponent* shadow_light = nullptr;
+  for (size_t light_id = first; light_id < end; light_id++) {
+    if (lights.at(light_id)->CanCastShadow()) {
+      shadow_light = lights[light_id];
+      break;
+    }
+  }
+
+  // Shaders loop over each light type separately (and only compile the loops for types present),
+  // so group the lights by type instead of branching per light.
+  const LightType kTypeOrder[] = {LightType::Ambient, LightType::Point, LightType::Directional};
+  block.light_counts = glm::ivec4(0);
+  size_t slot = 0;
+  for (int type_id = 0; type_id < 3; type_id++) {
+    for (size_t light_id = first; light_id < end; light_id++) {
+      LightComponent& light = *lights[light_id];
+      auto light_ptr = light.GetLightPtr();
+      if (light_ptr == nullptr) {
+        throw std::runtime_error("Light component has no light attached!");
+      }
+      if (light_ptr->GetType() != kTypeOrder[type_id]) {
+        continue;
+      }
+      PackLight(light, &light == shadow_light, block.lights[slot++]);
+      block.light_counts[type_id]++;
+    }
+  }
+  if (slot != end - first) {
+    throw std::runtime_error("Encountered light type unrecognized by the shader!");
+  }
+  return shadow_light;
+}
+
+unsigned GetLightFeatures(const LightBlock& block) {
+  return (block.light_counts[0] > 0 ? kAmbientLightsFeature : 0u) |
+         (block.light_counts[1] > 0 ? kPointLightsFeature : 0u) |
+         (block.light_counts[2] > 0 ? kDirectionalLightsFeature : 0u);
+}
+}  // namespace GLOO
@@ -0,0 +1,47 @@
+#ifndef GLOO_LIGHT_BLOCK_H_
+#define GLOO_LIGHT_BLOCK_H_
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+namespace GLOO {
+class LightComponent;
+
+// Lights shaded in one pass, mirroring the std140 `LightBlock` uniform block declared by the
+// lit shaders (toon_shading.frag, tone_mapping.frag and phong.frag). The renderer fills it
+// and binds it to kLightBlockBinding, so shaders only have to link their block to that point.
+const int kMaxLightsPerPass = 8;
+const GLuint kLightBlockBinding = 0;
+
+struct LightBlockEntry {
+  glm::vec4 position;     // point lights
+  glm::vec4 direction;    // directional lights
+  glm::vec4 diffuse;      // ambient color for ambient lights
+  glm::vec4 specular;
+  glm::vec4 attenuation;  // (constant, linear, quadratic), point lights
+  glm::ivec4 info;        // (LightType, uses the shadow map, unused, unused)
+};
+
+struct LightBlock {
+  LightBlockEntry lights[kMaxLightsPerPass];
+  // Lights are sorted by type: `light_counts` ambient lights first, then point lights, then
+  // directional lights. The last component is unused.
+  glm::ivec4 light_counts;
+};
+static_assert(sizeof(LightBlock) == kMaxLightsPerPass * 6 * 16 + 16,
+              "LightBlock must match the std140 layout of the GLSL block");
+
+// Writes the light of `component` into `entry`. Only one light per pass can use the shadow map.
+void PackLight(const LightComponent& component, bool uses_shadow_map, LightBlockEntry& entry);
+// Packs lights [first, end) of `lights` (at most kMaxLightsPerPass) into `block`, sorted by type.
+// The first of them that can cast shadows uses the shadow map and is returned, or nullptr if none
+// can.
+LightComponent* PackLights(const std::vector<LightComponent*>& lights, size_t first, size_t end,
+                           LightBlock& block);
+// Shader features (see ShaderFeature) needed to shade the light types present in `block`.
+unsigned GetLightFeatures(const LightBlock& block);
+}  // namespace GLOO
+
+#endif
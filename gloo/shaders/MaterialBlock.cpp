@@ -0,0 +1,34 @@
+#include "MaterialBlock.hpp"
+
+#include "gloo/Material.hpp"
+#include "gloo/SceneNode.hpp"
+#include "gloo/components/MaterialComponent.hpp"
+
+namespace GLOO {
+void PackMaterial(const Material& material, MaterialBlock& block) {
+  block = MaterialBlock();
+  block.ambient_color = material.GetAmbientColor();
+  block.shininess = material.GetShininess();
+  block.diffuse_color = material.GetDiffuseColor();
+  block.diffuse_intensity = material.GetDiffuseIntensity();
+  block.specular_color = material.GetSpecularColor();
+  block.specular_intensity = material.GetSpecularIntensity();
+  block.illuminated_color = material.GetIlluminatedColor();
+  block.shadow_color = material.GetShadowColor();
+}
+
+void PackNodeMaterial(const SceneNode& node, MaterialBlock& block) {
+  MaterialComponent* material_component_ptr = node.GetComponentPtr<MaterialComponent>();
+  if (material_component_ptr != nullptr) {
+    PackMaterial(material_component_ptr->GetMaterial(), block);
+    return;
+  }
+
+  PackMaterial(Material::GetDefault(), block);
+  const Material& default_npr = Material::GetDefaultNPR();
+  block.diffuse_intensity = default_npr.GetDiffuseIntensity();
+  block.specular_intensity = default_npr.GetSpecularIntensity();
+  block.illuminated_color = default_npr.GetIlluminatedColor();
+  block.shadow_color = default_npr.GetShadowColor();
+}
+}  // namespace GLOO
@@ -0,0 +1,38 @@
+#ifndef GLOO_MATERIAL_BLOCK_H_
+#define GLOO_MATERIAL_BLOCK_H_
+
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+namespace GLOO {
+class Material;
+class SceneNode;
+
+// Material of the object being drawn, mirroring the std140 `MaterialBlock` uniform block declared
+// by the lit shaders and g_buffer.frag. The renderer uploads it before each draw whose material
+// differs from the previous one (the render queue is sorted by material) and binds it to
+// kMaterialBlockBinding. Textures can't live in a uniform block, so they're still set by shaders.
+const GLuint kMaterialBlockBinding = 2;
+
+struct MaterialBlock {
+  glm::vec3 ambient_color;
+  float shininess;
+  glm::vec3 diffuse_color;
+  float diffuse_intensity;
+  glm::vec3 specular_color;
+  float specular_intensity;
+  glm::vec3 illuminated_color;  // NPR high color
+  float padding0;
+  glm::vec3 shadow_color;  // NPR low color
+  float padding1;
+};
+static_assert(sizeof(MaterialBlock) == 5 * 16,
+              "MaterialBlock must match the std140 layout of the GLSL block");
+
+void PackMaterial(const Material& material, MaterialBlock& block);
+// Packs the material of `node`. Nodes without a material get the realistic default's colors and
+// the NPR default's tones, which is what Phong and the NPR shaders fall back to respectively.
+void PackNodeMaterial(const SceneNode& node, MaterialBlock& block);
+}  // namespace GLOO
+
+#endif
@@ -3,6 +3,7 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/string_cast.hpp>
 #include <glm/matrix.hpp>
+#include <algorithm>
 #include <stdexcept>
 
 #include "gloo/InputManager.hpp"
@@ -15,27 +16,54 @@ namespace GLOO {
 MiterOutlineShader::MiterOutlineShader()
     : ShaderProgram(std::unordered_map<GLenum, std::string>{
           {GL_VERTEX_SHADER, "miter_outline.vert"}, {GL_FRAGMENT_SHADER, "miter_outline.frag"}}) {
-  vertex_ubo_ = CreateUBO();
-}
-
-void MiterOutlineShader::AssociateVertexArray(VertexArray& vertex_array) const {
-  if (!vertex_array.HasPositionBuffer()) {
-    throw std::runtime_error("Outline shader requires vertex positions!");
-  }
-  vertex_array.LinkPositionBuffer(GetAttributeLocation("vertex_position"));
+  GL_CHECK(glGenBuffers(1, &projected_buffer_));
+  GL_CHECK(glGenTextures(1, &projected_texture_));
+  projected_points_ = GetUniform<int>("projected_points");
+  material_color_ = GetUniform<glm::vec3>("material_color");
+  thickness_ = GetUniform<float>("u_thickness");
 }
 
 MiterOutlineShader::~MiterOutlineShader() {
-  // Delete assigned UBO buffer
-  glDeleteBuffers(1, &vertex_ubo_);
+  // Delete projected points and their texture buffer
+  glDeleteTextures(1, &projected_texture_);
+  glDeleteBuffers(1, &projected_buffer_);
 }
 
 void MiterOutlineShader::SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const {
-  // Create a UBO from the vertex positions before rendering
-  UpdateUBO(node.GetComponentPtr<RenderingComponent>()->GetVertexObjectPtr()->GetPositions());
+  auto& vertex_array =
+      node.GetComponentPtr<RenderingComponent>()->GetVertexObjectPtr()->GetVertexArray();
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("Miter outline shader requires vertex positions!");
+  }
+
+  // Project the node's points, unless the buffer already holds them for this camera.
+  glm::mat4 mvp = view_projection_ * model_matrix;
+  size_t num_points = vertex_array.GetPositionBufferSize();
+  GLuint source = vertex_array.GetPositionBufferHandle();
+  unsigned int version = vertex_array.GetPositionBufferVersion();
+  if (source != projected_source_ || version != projected_version_ || mvp != projected_mvp_ ||
+      resolution_ != projected_resolution_) {
+    if (num_points > projected_capacity_) {
+      projected_capacity_ = std::max(num_points, projected_capacity_ + projected_capacity_ / 2);
+      GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, projected_buffer_));
+      GL_CHECK(glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * projected_capacity_, nullptr,
+                            GL_DYNAMIC_COPY));
+      GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+      GL_CHECK(glBindTexture(GL_TEXTURE_BUFFER, projected_texture_));
+      GL_CHECK(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, projected_buffer_));
+    }
+    projection_shader_.Project(vertex_array, num_points, mvp, resolution_, projected_buffer_);
+    // Projecting switches programs, so switch back before the draw call.
+    Bind();
+    projected_source_ = source;
+    projected_version_ = version;
+    projected_mvp_ = mvp;
+    projected_resolution_ = resolution_;
+  }
 
-  // Set transform.
-  SetUniform("model_matrix", model_matrix);
+  GL_CHECK(glActiveTexture(GL_TEXTURE0 + projected_texture_unit_));
+  GL_CHECK(glBindTexture(GL_TEXTURE_BUFFER, projected_texture_));
+  SetUniform(projected_points_, projected_texture_unit_);
 
   // Set material.
   MaterialComponent* material_component_ptr = node.GetComponentPtr<MaterialComponent>();
@@ -46,78 +74,17 @@ void MiterOutlineShader::SetTargetNode(const SceneNode& node, const glm::mat4& m
     material_ptr = &material_component_ptr->GetMaterial();
   }
 
-  SetUniform("material_color", material_ptr->GetOutlineColor());
-  SetUniform("u_thickness", material_ptr->GetOutlineThickness());
+  SetUniform(material_color_, material_ptr->GetOutlineColor());
+  SetUniform(thickness_, material_ptr->GetOutlineThickness());
 }
 
 void MiterOutlineShader::SetCamera(const CameraComponent& camera) const {
   // Update shader using window size
   glm::ivec2 window_size = InputManager::GetInstance().GetWindowSize();
-  glm::vec2 float_window_size = glm::vec2((float)window_size.x, (float)window_size.y);
-  SetUniform("u_resolution", float_window_size);
-
-  SetUniform("view_matrix", camera.GetViewMatrix());
-
-  glm::mat4 modelview2(1.0f);
-  modelview2 = glm::translate(modelview2, glm::vec3(0.6f, 0.0f, 0.0f));
-  modelview2 = glm::scale(modelview2, glm::vec3(0.5f, 0.5f, 1.0f));
-  SetUniform("model_view_project_matrix", camera.GetProjectionMatrix() * camera.GetViewMatrix());
-  SetUniform("projection_matrix", camera.GetProjectionMatrix());
-}
-
-GLuint MiterOutlineShader::CreateUBO() const {
-  GLuint ubo;
-  GL_CHECK(glGenBuffers(1, &ubo));
-  GL_CHECK(glBindBuffer(GL_UNIFORM_BUFFER, ubo));
-
-  // Allocate space for the UBO data (size of VertexInfo + maxUBOArraySize - 1 * sizeof(glm::vec4))
-  GL_CHECK(glBufferData(GL_UNIFORM_BUFFER,
-                        sizeof(VertexInfo) + (maxUBOArraySize - 1) * sizeof(glm::vec4), NULL,
-                        GL_DYNAMIC_DRAW));  // Use GL_DYNAMIC_DRAW so we can use mapping
-
-  // Bind the UBO to a binding point (here we choose 0)
-  GL_CHECK(glBindBufferBase(GL_UNIFORM_BUFFER, buffer_binding_point_, ubo));
-
-  return ubo;
-}
-
-void MiterOutlineShader::ReinitializeUBO() const {
-  // Bind buffer
-  GL_CHECK(glBindBuffer(GL_UNIFORM_BUFFER, vertex_ubo_));
-
-  // Allocate space for the UBO data (size of VertexInfo + maxUBOArraySize - 1 * sizeof(glm::vec4))
-  GL_CHECK(glBufferData(GL_UNIFORM_BUFFER,
-                        sizeof(VertexInfo) + (maxUBOArraySize - 1) * sizeof(glm::vec4), NULL,
-                        GL_DYNAMIC_DRAW));
-}
-
-void MiterOutlineShader::UpdateUBO(const std::vector<glm::vec3>& varray) const {
-  GL_CHECK(glBindBuffer(GL_UNIFORM_BUFFER, vertex_ubo_));
-
-  // Map the buffer for writing
-  VertexInfo* uboData = static_cast<VertexInfo*>(glMapBufferRange(
-      GL_UNIFORM_BUFFER, 0, sizeof(VertexInfo), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
-
-  if (!uboData) {
-    // Handle error: Unable to map the buffer
-    throw std::runtime_error("unable to map buffer");
-    return;
-  }
-
-  // Populate the array with data
-  for (int i = 0; i < varray.size(); ++i) {
-    uboData->myVec4Array[i] = glm::vec4(varray[i], 1.0f);
-  }
-
-  // Unmap the buffer, and if the unmap operation fails, we need to reinitialize the buffer
-  if (GL_CHECK(glUnmapBuffer(GL_UNIFORM_BUFFER)) == GL_FALSE) {
-    std::cerr << "Unmapping operation in MiterOutlineShader failed, reinitializing UBO"
-              << std::endl;
-    ReinitializeUBO();
-  }
-
-  // Bind the UBO to the binding point
-  GL_CHECK(glBindBufferBase(GL_UNIFORM_BUFFER, buffer_binding_point_, vertex_ubo_));
+  resolution_ = glm::vec2((float)window_size.x, (float)window_size.y);
+  SetUniform("u_resolution", resolution_);
+  // Target nodes are projected in SetTargetNode, which the renderer calls after SetCamera.
+  view_projection_ = camera.GetProjectionMatrix() * camera.GetViewMatrix();
 }
 
-}  // namespace GLOO
\ No newline at end of file
+}  // namespace GLOO
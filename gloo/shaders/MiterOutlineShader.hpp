@@ -1,17 +1,22 @@
 #ifndef GLOO_MITER_OUTLINE_SHADER_H
 #define GLOO_MITER_OUTLINE_SHADER_H
+#include "PointProjectionShader.hpp"
 #include "ShaderProgram.hpp"
 
 namespace GLOO {
 /**
  * Shader for created outlines with a desired thickness.
+ *
+ * The target node's polyline points are first projected to window space with a transform
+ * feedback pass, and the miter vertex shader reads the projected points through a texture buffer,
+ * so each point is projected once instead of for every vertex of its four neighboring segments.
+ * The projection is skipped when the points and camera haven't changed since the last pass (e.g.
+ * for the depth pre-pass and the following light passes of a frame).
+ *
+ * For a polyline whose (padded) points start at position `base`, segment j is drawn by vertices
+ * 6 * (base + j) ... 6 * (base + j) + 5, which read points base + j ... base + j + 3 (the segment
+ * plus its two neighbors).
  */
-const size_t maxUBOArraySize = 1024;
-struct VertexInfo {
-  // int arraySize;
-  glm::vec4 myVec4Array[maxUBOArraySize];  // Minimum array size (adjust as needed)
-};
-
 class MiterOutlineShader : public ShaderProgram {
  public:
   MiterOutlineShader();
@@ -20,14 +25,27 @@ class MiterOutlineShader : public ShaderProgram {
   void SetCamera(const CameraComponent& camera) const override;
 
  private:
-  void AssociateVertexArray(VertexArray& vertex_array) const;
-  GLuint CreateUBO() const;
-  void UpdateUBO(const std::vector<glm::vec3>& varray) const;
-  void ReinitializeUBO() const;
-  GLuint vertex_ubo_;
-  // Since TVertex is the first UBO in the vertex shader, its binding point is 0.
-  GLuint buffer_binding_point_ = 0;
+  PointProjectionShader projection_shader_;
+  // Buffer of projected points, and the texture buffer viewing it
+  GLuint projected_buffer_;
+  GLuint projected_texture_;
+  // Texture unit the projected points are bound to
+  const int projected_texture_unit_ = 0;
+
+  UniformHandle<int> projected_points_;
+  UniformHandle<glm::vec3> material_color_;
+  UniformHandle<float> thickness_;
+
+  // Camera state recorded by SetCamera, used to project each target node in SetTargetNode
+  mutable glm::mat4 view_projection_;
+  mutable glm::vec2 resolution_;
+  // What the projected buffer currently holds
+  mutable size_t projected_capacity_ = 0;
+  mutable GLuint projected_source_ = 0;
+  mutable unsigned int projected_version_ = 0;
+  mutable glm::mat4 projected_mvp_;
+  mutable glm::vec2 projected_resolution_;
 };
 
 }  // namespace GLOO
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,42 @@
+#include "NormalDepthShader.hpp"
+
+#include <glm/matrix.hpp>
+#include <stdexcept>
+
+#include "gloo/SceneNode.hpp"
+#include "gloo/components/RenderingComponent.hpp"
+#include "gloo/shaders/CameraBlock.hpp"
+
+namespace GLOO {
+NormalDepthShader::NormalDepthShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>(
+          {{GL_VERTEX_SHADER, "normal_depth.vert"}, {GL_FRAGMENT_SHADER, "normal_depth.frag"}})) {
+  BindUniformBlock("CameraBlock", kCameraBlockBinding);
+  model_matrix_ = GetUniform<glm::mat4>("model_matrix");
+  normal_matrix_ = GetUniform<glm::mat3>("normal_matrix");
+}
+
+void NormalDepthShader::AssociateVertexArray(VertexArray& vertex_array) const {
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("Normal depth shader requires vertex positions!");
+  }
+  if (!vertex_array.HasNormalBuffer()) {
+    throw std::runtime_error("Normal depth shader requires vertex normals!");
+  }
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+  vertex_array.LinkNormalBuffer(kNormalAttribLocation);
+}
+
+void NormalDepthShader::SetTargetNode(const SceneNode& node,
+                                      const glm::mat4& model_matrix) const {
+  // Associate the right VAO before rendering.
+  AssociateVertexArray(
+      node.GetComponentPtr<RenderingComponent>()->GetVertexObjectPtr()->GetVertexArray());
+
+  // Set transform.
+  glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(model_matrix)));
+  SetUniform(model_matrix_, model_matrix);
+  SetUniform(normal_matrix_, normal_matrix);
+  // The camera is read from the camera block the renderer uploads.
+}
+}  // namespace GLOO
@@ -0,0 +1,21 @@
+#ifndef GLOO_NORMAL_DEPTH_SHADER_H_
+#define GLOO_NORMAL_DEPTH_SHADER_H_
+
+#include "ShaderProgram.hpp"
+
+namespace GLOO {
+// Writes view space normals (rgb) and view space depth (a) of surfaces, for screen space effects.
+class NormalDepthShader : public ShaderProgram {
+ public:
+  NormalDepthShader();
+  void SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const override;
+
+ private:
+  void AssociateVertexArray(VertexArray& vertex_array) const;
+
+  UniformHandle<glm::mat4> model_matrix_;
+  UniformHandle<glm::mat3> normal_matrix_;
+};
+}  // namespace GLOO
+
+#endif
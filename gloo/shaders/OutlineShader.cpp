@@ -10,18 +10,23 @@
 #include "gloo/components/CameraComponent.hpp"
 #include "gloo/components/MaterialComponent.hpp"
 #include "gloo/components/RenderingComponent.hpp"
+#include "gloo/shaders/CameraBlock.hpp"
 
 namespace GLOO {
 OutlineShader::OutlineShader()
     : ShaderProgram(std::unordered_map<GLenum, std::string>{{GL_VERTEX_SHADER, "outline.vert"},
                                                             {GL_GEOMETRY_SHADER, "outline.geom"},
                                                             {GL_FRAGMENT_SHADER, "outline.frag"}}) {
+  BindUniformBlock("CameraBlock", kCameraBlockBinding);
+  model_matrix_ = GetUniform<glm::mat4>("model_matrix");
+  material_color_ = GetUniform<glm::vec3>("material_color");
+  thickness_ = GetUniform<float>("u_thickness");
 }
 void OutlineShader::AssociateVertexArray(VertexArray& vertex_array) const {
   if (!vertex_array.HasPositionBuffer()) {
     throw std::runtime_error("Outline shader requires vertex positions!");
   }
-  vertex_array.LinkPositionBuffer(GetAttributeLocation("vertex_position"));
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
 }
 
 void OutlineShader::SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const {
@@ -30,7 +35,7 @@ void OutlineShader::SetTargetNode(const SceneNode& node, const glm::mat4& model_
       node.GetComponentPtr<RenderingComponent>()->GetVertexObjectPtr()->GetVertexArray());
 
   // Set transform.
-  SetUniform("model_matrix", model_matrix);
+  SetUniform(model_matrix_, model_matrix);
 
   // Set material.
   MaterialComponent* material_component_ptr = node.GetComponentPtr<MaterialComponent>();
@@ -41,8 +46,8 @@ void OutlineShader::SetTargetNode(const SceneNode& node, const glm::mat4& model_
     material_ptr = &material_component_ptr->GetMaterial();
   }
 
-  SetUniform("material_color", material_ptr->GetOutlineColor());
-  SetUniform("u_thickness", material_ptr->GetOutlineThickness());
+  SetUniform(material_color_, material_ptr->GetOutlineColor());
+  SetUniform(thickness_, material_ptr->GetOutlineThickness());
 }
 
 void OutlineShader::SetCamera(const CameraComponent& camera) const {
@@ -51,8 +56,7 @@ void OutlineShader::SetCamera(const CameraComponent& camera) const {
   glm::vec2 inverse_window_size = glm::vec2(1. / window_size.x, 1. / window_size.y);
   SetUniform("u_viewportInvSize", inverse_window_size);
 
-  SetUniform("view_matrix", camera.GetViewMatrix());
-  SetUniform("projection_matrix", camera.GetProjectionMatrix());
+  // The view and projection are read from the camera block the renderer uploads.
 }
 
 }  // namespace GLOO
\ No newline at end of file
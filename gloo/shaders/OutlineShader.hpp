@@ -16,6 +16,10 @@ class OutlineShader : public ShaderProgram {
 
  private:
   void AssociateVertexArray(VertexArray& vertex_array) const;
+
+  UniformHandle<glm::mat4> model_matrix_;
+  UniformHandle<glm::vec3> material_color_;
+  UniformHandle<float> thickness_;
 };
 
 }  // namespace GLOO
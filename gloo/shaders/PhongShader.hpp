@@ -4,13 +4,14 @@
 #include "ShaderProgram.hpp"
 
 namespace GLOO {
+class Material;
+
 class PhongShader : public ShaderProgram {
  public:
   PhongShader();
   void SetTargetNode(const SceneNode& node,
                      const glm::mat4& model_matrix) const override;
-  void SetCamera(const CameraComponent& camera) const override;
-  void SetLightSource(const LightComponent& componentt) const override;
+  unsigned GetNodeFeatures(const SceneNode& node) const override;
 
   void SetShadowMapping(
       const Texture& shadow_texture,
@@ -18,11 +19,18 @@ class PhongShader : public ShaderProgram {
 
  private:
   void AssociateVertexArray(VertexArray& vertex_array) const;
+  static const Material& GetNodeMaterial(const SceneNode& node);
   static const int diffuse_texture_unit = 0;
   static const int specular_texture_unit = 1;
   static const int ambient_texture_unit = 2;
   static const int shadow_map_unit = 3;
   const float shadow_bias_ = 0.001;  // No bias value is perfect, but this works pretty well
+
+  UniformHandle<glm::mat4> model_matrix_;
+  UniformHandle<glm::mat3> normal_matrix_;
+  UniformHandle<int> diffuse_sampler_;
+  UniformHandle<int> specular_sampler_;
+  UniformHandle<int> ambient_sampler_;
 };
 }  // namespace GLOO
 
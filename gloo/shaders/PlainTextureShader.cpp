@@ -19,8 +19,8 @@ void PlainTextureShader::AssociateVertexArray(
     throw std::runtime_error(
         "Plain texture shader requires vertex texture coordinates!");
   }
-  vertex_array.LinkPositionBuffer(GetAttributeLocation("vertex_ndc_position"));
-  vertex_array.LinkTexCoordBuffer(GetAttributeLocation("vertex_tex_coord"));
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+  vertex_array.LinkTexCoordBuffer(kTexCoordAttribLocation);
 }
 
 void PlainTextureShader::SetVertexObject(const VertexObject& obj) const {
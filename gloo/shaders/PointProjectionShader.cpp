@@ -0,0 +1,37 @@
+#include "PointProjectionShader.hpp"
+
+#include "gloo/gl_wrapper/BindGuard.hpp"
+
+namespace GLOO {
+PointProjectionShader::PointProjectionShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>{{GL_VERTEX_SHADER,
+                                                             "point_projection.vert"}},
+                    {"projected_position"}) {
+}
+
+void PointProjectionShader::Project(const VertexArray& vertex_array, size_t num_points,
+                                    const glm::mat4& model_view_projection,
+                                    const glm::vec2& resolution, GLuint output_buffer) const {
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("Point projection shader requires vertex positions!");
+  }
+  if (num_points == 0) {
+    return;
+  }
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+
+  BindGuard shader_bg(this);
+  SetUniform("model_view_projection_matrix", model_view_projection);
+  SetUniform("u_resolution", resolution);
+
+  BindGuard vao_bg(&vertex_array);
+  // Only the captured outputs are needed, nothing is rasterized.
+  GL_CHECK(glEnable(GL_RASTERIZER_DISCARD));
+  GL_CHECK(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, output_buffer));
+  GL_CHECK(glBeginTransformFeedback(GL_POINTS));
+  GL_CHECK(glDrawArrays(GL_POINTS, 0, (GLsizei)num_points));
+  GL_CHECK(glEndTransformFeedback());
+  GL_CHECK(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0));
+  GL_CHECK(glDisable(GL_RASTERIZER_DISCARD));
+}
+}  // namespace GLOO
@@ -0,0 +1,26 @@
+#ifndef GLOO_POINT_PROJECTION_SHADER_H
+#define GLOO_POINT_PROJECTION_SHADER_H
+
+#include "ShaderProgram.hpp"
+
+namespace GLOO {
+/**
+ * Transform feedback shader that projects points to window space once, so shaders that need
+ * several projected neighbors per vertex (e.g. MiterOutlineShader) can read them from a buffer.
+ */
+class PointProjectionShader : public ShaderProgram {
+ public:
+  PointProjectionShader();
+
+  /**
+   * Projects the first `num_points` positions of `vertex_array` into `output_buffer`, which must
+   * hold at least `num_points` vec4s. Each output is (window x, window y, NDC z, clip w).
+   * Leaves no program bound.
+   */
+  void Project(const VertexArray& vertex_array, size_t num_points,
+               const glm::mat4& model_view_projection, const glm::vec2& resolution,
+               GLuint output_buffer) const;
+};
+}  // namespace GLOO
+
+#endif
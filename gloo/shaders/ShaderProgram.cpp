@@ -1,141 +1,209 @@
 #include "ShaderProgram.hpp"
 
-#include <iterator>
+#include <algorithm>
 #include <stdexcept>
 #include <unordered_map>
 #include <iostream>
-#include <fstream>
 
 #include <glm/gtc/type_ptr.hpp>
 
 #include <gloo/utils.hpp>
+#include "gloo/gl_wrapper/GLStateCache.hpp"
+#include "ShaderRegistry.hpp"
+
+namespace {
+// Defines that enable each ShaderFeature, in bit order.
+const char* const kFeatureDefines[] = {"AMBIENT_LIGHTS",  "POINT_LIGHTS",     "DIRECTIONAL_LIGHTS",
+                                       "SHADOW_MAP",      "DIFFUSE_TEXTURE",  "SPECULAR_TEXTURE",
+                                       "AMBIENT_TEXTURE"};
+}  // namespace
 
 namespace GLOO {
 ShaderProgram::ShaderProgram(
-    const std::unordered_map<GLenum, std::string>& shader_filenames) {
+    const std::unordered_map<GLenum, std::string>& shader_filenames,
+    const std::vector<std::string>& feedback_varyings, unsigned supported_features)
+    : shader_filenames_(shader_filenames),
+      feedback_varyings_(feedback_varyings),
+      supported_features_(supported_features) {
   assert(shader_filenames.count(GL_VERTEX_SHADER) == 1);
-  assert(shader_filenames.count(GL_FRAGMENT_SHADER) == 1);
-  for (auto& kv : shader_filenames) {
-    std::string shader_path = GetShaderGLSLDir() + kv.second;
-    std::ifstream ifs(shader_path, std::ifstream::in);
-    std::string shader_code(std::istreambuf_iterator<char>{ifs}, {});
-    shader_handles_[kv.first] = LoadShader(kv.first, shader_code, shader_path);
-  }
-
-  shader_program_ = glCreateProgram();
-  GL_CHECK_ERROR();
-
-  for (auto& kv : shader_handles_) {
-    GL_CHECK(glAttachShader(shader_program_, kv.second));
-  }
-
-  GL_CHECK(glLinkProgram(shader_program_));
-  GLint link_status;
-  GL_CHECK(glGetProgramiv(shader_program_, GL_LINK_STATUS, &link_status));
-  if (link_status != GL_TRUE) {
-    GLchar err_log_buf[kErrorLogBufferSize];
-    GL_CHECK(glGetProgramInfoLog(shader_program_, kErrorLogBufferSize, nullptr,
-                                 err_log_buf));
-    std::cerr << "Shader linking error: " << err_log_buf << std::endl;
-    return;
-  }
-
-  // Cleanup after linking.
-  for (auto& kv : shader_handles_) {
-    GLuint handle = kv.second;
-    GL_CHECK(glDetachShader(shader_program_, handle));
-    GL_CHECK(glDeleteShader(handle));
-  }
+  assert(shader_filenames.count(GL_FRAGMENT_SHADER) == 1 || !feedback_varyings.empty());
+  current_variant_ = &GetVariant(0);
 }
 
 ShaderProgram::~ShaderProgram() {
-  GL_CHECK(glDeleteProgram(shader_program_));
+  for (auto& kv : variants_) {
+    ShaderRegistry::GetInstance().Release(kv.second.program);
+  }
 }
 
 void ShaderProgram::Bind() const {
-  GL_CHECK(glUseProgram(shader_program_));
+  GLStateCache::GetInstance().UseProgram(current_variant_->program);
 }
 
 void ShaderProgram::Unbind() const {
-  GL_CHECK(glUseProgram(0));
+  GLStateCache::GetInstance().UseProgram(0);
 }
 
 GLint ShaderProgram::GetAttributeLocation(const std::string& name) const {
-  GLint loc = glGetAttribLocation(shader_program_, name.c_str());
+  GLint loc = glGetAttribLocation(current_variant_->program, name.c_str());
   GL_CHECK_ERROR();
   return loc;
 }
 
-GLuint ShaderProgram::LoadShader(GLenum type,
-                                 std::string shader_code,
-                                 const std::string& shader_file_name) {
-  GLuint shader_handle = glCreateShader(type);
-  GL_CHECK_ERROR();
-  auto version_pos = shader_code.find("#version");
-  if (version_pos == std::string::npos) {
-    throw std::runtime_error("Shader file " + shader_file_name +
-                             " has no #version!");
+bool ShaderProgram::SelectVariant(unsigned features) const {
+  Variant* variant = &GetVariant(features & supported_features_);
+  if (variant == current_variant_) {
+    return false;
   }
-  auto version_end = shader_code.find('\n', version_pos);
-  std::string version =
-      shader_code.substr(version_pos, version_end + 1 - version_pos);
-  shader_code = shader_code.substr(version_end + 1);
-  std::vector<const char*> codes = {version.c_str(), shader_code.c_str()};
-
-  codes.insert(codes.begin() + 1, "#define ASSIGNMENT_5_STARTER\n");
-  GL_CHECK(glShaderSource(shader_handle, (GLsizei)codes.size(), codes.data(),
-                          nullptr));
-  GL_CHECK(glCompileShader(shader_handle));
-
-  GLint compile_status;
-  GL_CHECK(glGetShaderiv(shader_handle, GL_COMPILE_STATUS, &compile_status));
-  if (compile_status != GL_TRUE) {
-    char err_log_buf[kErrorLogBufferSize];
-    GL_CHECK(glGetShaderInfoLog(shader_handle, kErrorLogBufferSize, nullptr,
-                                err_log_buf));
-    std::cerr << "Shader compilation error: " << err_log_buf << std::endl;
-    return 0;
+  current_variant_ = variant;
+  return true;
+}
+
+ShaderProgram::Variant& ShaderProgram::GetVariant(unsigned features) const {
+  auto it = variants_.find(features);
+  if (it != variants_.end()) {
+    return it->second;
   }
 
-  return shader_handle;
+  std::vector<std::string> defines;
+  for (size_t bit = 0; bit < sizeof(kFeatureDefines) / sizeof(kFeatureDefines[0]); bit++) {
+    if (features & (1u << bit)) {
+      defines.push_back(kFeatureDefines[bit]);
+    }
+  }
+  // Shaders built from the same files and defines share one program.
+  GLuint program =
+      ShaderRegistry::GetInstance().Acquire(shader_filenames_, feedback_varyings_, defines);
+  Variant& variant = variants_[features];
+  variant.program = program;
+
+  GLint uniform_count = 0;
+  GLint max_name_length = 0;
+  GL_CHECK(glGetProgramiv(variant.program, GL_ACTIVE_UNIFORMS, &uniform_count));
+  GL_CHECK(glGetProgramiv(variant.program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length));
+  std::vector<GLchar> name_buf(std::max(max_name_length, 1));
+  for (GLint i = 0; i < uniform_count; i++) {
+    GLsizei name_length;
+    GLint size;
+    GLenum type;
+    GL_CHECK(glGetActiveUniform(variant.program, static_cast<GLuint>(i),
+                                static_cast<GLsizei>(name_buf.size()), &name_length, &size, &type,
+                                name_buf.data()));
+    std::string name(name_buf.data(), name_length);
+    // Members of uniform blocks have no location.
+    GLint loc = glGetUniformLocation(variant.program, name.c_str());
+    GL_CHECK_ERROR();
+    if (loc == -1) {
+      continue;
+    }
+    variant.uniform_locations[name] = loc;
+    // Arrays are reported as "name[0]", but can also be set by their plain name.
+    auto array_pos = name.rfind("[0]");
+    if (array_pos != std::string::npos && array_pos + 3 == name.size()) {
+      variant.uniform_locations[name.substr(0, array_pos)] = loc;
+    }
+  }
+
+  // Apply what was registered for the variants built so far.
+  for (auto& name : handle_names_) {
+    variant.handle_locations.push_back(GetUniformLocation(variant, name));
+  }
+  for (auto& block : uniform_block_bindings_) {
+    LinkUniformBlock(variant, block.first, block.second);
+  }
+  return variant;
+}
+
+size_t ShaderProgram::RegisterUniform(const std::string& name) const {
+  handle_names_.push_back(name);
+  for (auto& kv : variants_) {
+    kv.second.handle_locations.push_back(GetUniformLocation(kv.second, name));
+  }
+  return handle_names_.size() - 1;
+}
+
+GLint ShaderProgram::GetUniformLocation(const Variant& variant, const std::string& name) {
+  auto it = variant.uniform_locations.find(name);
+  return it == variant.uniform_locations.end() ? -1 : it->second;
 }
 
 void ShaderProgram::SetUniform(const std::string& name,
                                const glm::mat4& value) const {
-  GLint loc = glGetUniformLocation(shader_program_, name.c_str());
-  GL_CHECK_ERROR();
+  GLint loc = GetUniformLocation(*current_variant_, name);
   GL_CHECK(glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(value)));
 }
 
 void ShaderProgram::SetUniform(const std::string& name,
                                const glm::mat3& value) const {
-  GLint loc = glGetUniformLocation(shader_program_, name.c_str());
-  GL_CHECK_ERROR();
+  GLint loc = GetUniformLocation(*current_variant_, name);
   GL_CHECK(glUniformMatrix3fv(loc, 1, GL_FALSE, glm::value_ptr(value)));
 }
 
 void ShaderProgram::SetUniform(const std::string& name,
                                const glm::vec3& value) const {
-  GLint loc = glGetUniformLocation(shader_program_, name.c_str());
-  GL_CHECK_ERROR();
+  GLint loc = GetUniformLocation(*current_variant_, name);
   GL_CHECK(glUniform3fv(loc, 1, glm::value_ptr(value)));
 }
 
 void ShaderProgram::SetUniform(const std::string& name, const glm::vec2& value) const {
-  GLint loc = glGetUniformLocation(shader_program_, name.c_str());
-  GL_CHECK_ERROR();
+  GLint loc = GetUniformLocation(*current_variant_, name);
   GL_CHECK(glUniform2fv(loc, 1, glm::value_ptr(value)));
 }
 
 void ShaderProgram::SetUniform(const std::string& name, float value) const {
-  GLint loc = glGetUniformLocation(shader_program_, name.c_str());
-  GL_CHECK_ERROR();
+  GLint loc = GetUniformLocation(*current_variant_, name);
   GL_CHECK(glUniform1f(loc, value));
 }
 
 void ShaderProgram::SetUniform(const std::string& name, int value) const {
-  GLint loc = glGetUniformLocation(shader_program_, name.c_str());
-  GL_CHECK_ERROR();
+  GLint loc = GetUniformLocation(*current_variant_, name);
+  GL_CHECK(glUniform1i(loc, value));
+}
+
+void ShaderProgram::SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4& value) const {
+  GLint loc = current_variant_->handle_locations[handle.GetSlot()];
+  GL_CHECK(glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(value)));
+}
+
+void ShaderProgram::SetUniform(UniformHandle<glm::mat3> handle, const glm::mat3& value) const {
+  GLint loc = current_variant_->handle_locations[handle.GetSlot()];
+  GL_CHECK(glUniformMatrix3fv(loc, 1, GL_FALSE, glm::value_ptr(value)));
+}
+
+void ShaderProgram::SetUniform(UniformHandle<glm::vec3> handle, const glm::vec3& value) const {
+  GLint loc = current_variant_->handle_locations[handle.GetSlot()];
+  GL_CHECK(glUniform3fv(loc, 1, glm::value_ptr(value)));
+}
+
+void ShaderProgram::SetUniform(UniformHandle<glm::vec2> handle, const glm::vec2& value) const {
+  GLint loc = current_variant_->handle_locations[handle.GetSlot()];
+  GL_CHECK(glUniform2fv(loc, 1, glm::value_ptr(value)));
+}
+
+void ShaderProgram::SetUniform(UniformHandle<float> handle, float value) const {
+  GLint loc = current_variant_->handle_locations[handle.GetSlot()];
+  GL_CHECK(glUniform1f(loc, value));
+}
+
+void ShaderProgram::SetUniform(UniformHandle<int> handle, int value) const {
+  GLint loc = current_variant_->handle_locations[handle.GetSlot()];
   GL_CHECK(glUniform1i(loc, value));
 }
+
+void ShaderProgram::BindUniformBlock(const std::string& name, GLuint binding) const {
+  uniform_block_bindings_.emplace_back(name, binding);
+  for (auto& kv : variants_) {
+    LinkUniformBlock(kv.second, name, binding);
+  }
+}
+
+void ShaderProgram::LinkUniformBlock(const Variant& variant, const std::string& name,
+                                     GLuint binding) {
+  GLuint index = glGetUniformBlockIndex(variant.program, name.c_str());
+  GL_CHECK_ERROR();
+  if (index == GL_INVALID_INDEX) {
+    return;
+  }
+  GL_CHECK(glUniformBlockBinding(variant.program, index, binding));
+}
 }  // namespace GLOO
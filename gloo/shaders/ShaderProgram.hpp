@@ -5,6 +5,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <glad/glad.h>
 
@@ -14,30 +15,79 @@
 
 namespace GLOO {
 class CameraComponent;
-class LightComponent;
 class SceneNode;
 
+// Lighting equations the deferred lighting pass can evaluate from the G-buffer. The values are
+// stored in the G-buffer, so they must match deferred_lighting.frag.
+enum class DeferredShadingModel { None = 0, ToneMapping = 1, Toon = 2 };
+
+// Optional features of a shader, each compiled in with a #define (e.g. kPointLightsFeature adds
+// "#define POINT_LIGHTS"). Shaders build a variant for every combination of their supported
+// features that gets selected, so the GLSL can drop unused code instead of branching on it.
+enum ShaderFeature : unsigned {
+  kAmbientLightsFeature = 1 << 0,      // AMBIENT_LIGHTS
+  kPointLightsFeature = 1 << 1,        // POINT_LIGHTS
+  kDirectionalLightsFeature = 1 << 2,  // DIRECTIONAL_LIGHTS
+  kShadowMapFeature = 1 << 3,          // SHADOW_MAP
+  kDiffuseTextureFeature = 1 << 4,     // DIFFUSE_TEXTURE
+  kSpecularTextureFeature = 1 << 5,    // SPECULAR_TEXTURE
+  kAmbientTextureFeature = 1 << 6,     // AMBIENT_TEXTURE
+};
+// Features selected by the light types in a pass (see GetLightFeatures).
+const unsigned kLightFeatures =
+    kAmbientLightsFeature | kPointLightsFeature | kDirectionalLightsFeature;
+
+// Uniform of type `T`, registered once with ShaderProgram::GetUniform. Its location is resolved
+// when each variant is linked, so setting it per draw needs no name lookup. Setting it with a
+// value of another type doesn't compile.
+template <class T>
+class UniformHandle {
+ public:
+  UniformHandle() : slot_(0) {}
+  explicit UniformHandle(size_t slot) : slot_(slot) {}
+  size_t GetSlot() const {
+    return slot_;
+  }
+
+ private:
+  size_t slot_;
+};
+
 class ShaderProgram : public IBindable {
  public:
-  ShaderProgram(
-      const std::unordered_map<GLenum, std::string>& shader_filenames);
+  // Programs that capture `feedback_varyings` with transform feedback don't need a fragment
+  // shader. `supported_features` (ShaderFeature flags) are the features variants can enable.
+  ShaderProgram(const std::unordered_map<GLenum, std::string>& shader_filenames,
+                const std::vector<std::string>& feedback_varyings = {},
+                unsigned supported_features = 0);
   virtual ~ShaderProgram();
   void Bind() const override;
   void Unbind() const override;
   GLint GetAttributeLocation(const std::string& name) const;
 
+  // Makes the variant with `features` (ignoring unsupported ones) the one that's bound and
+  // receives uniforms, building it the first time. Returns whether the variant changed, in which
+  // case the shader has to be bound and its per pass uniforms set again.
+  bool SelectVariant(unsigned features) const;
+  // Features that drawing `node` needs on top of the pass' features, e.g. material textures.
+  virtual unsigned GetNodeFeatures(const SceneNode& node) const {
+    return 0;
+  }
+
   // The following Set* methods are called by the renderer, thus const.
   virtual void SetTargetNode(const SceneNode& node,
                              const glm::mat4& local_to_world_mat) const {
   }
   virtual void SetCamera(const CameraComponent& camera) const {
   }
-  virtual void SetLightSource(const LightComponent& light) const {
-  }
   virtual void SetShadowMapping(
       const Texture& shadow_texture,
       const glm::mat4& world_to_light_NDC_matrix) const {
   }
+  // Objects whose shader has no deferred shading model are always shaded forward.
+  virtual DeferredShadingModel GetDeferredShadingModel() const {
+    return DeferredShadingModel::None;
+  }
 
  protected:
   // Protected because only shader subclasses have information to the names.
@@ -47,16 +97,40 @@ class ShaderProgram : public IBindable {
   void SetUniform(const std::string& name, const glm::vec2& value) const;
   void SetUniform(const std::string& name, float value) const;
   void SetUniform(const std::string& name, int value) const;
+  template <class T>
+  UniformHandle<T> GetUniform(const std::string& name) const {
+    return UniformHandle<T>(RegisterUniform(name));
+  }
+  void SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4& value) const;
+  void SetUniform(UniformHandle<glm::mat3> handle, const glm::mat3& value) const;
+  void SetUniform(UniformHandle<glm::vec3> handle, const glm::vec3& value) const;
+  void SetUniform(UniformHandle<glm::vec2> handle, const glm::vec2& value) const;
+  void SetUniform(UniformHandle<float> handle, float value) const;
+  void SetUniform(UniformHandle<int> handle, int value) const;
+  // Links uniform block `name` to the buffer bound at `binding` in every variant that uses it.
+  void BindUniformBlock(const std::string& name, GLuint binding) const;
 
  private:
-  static GLuint LoadShader(GLenum type,
-                           std::string shader_code,
-                           const std::string& shader_filename);
-
-  const static int kErrorLogBufferSize = 512;
+  struct Variant {
+    GLuint program;
+    // Locations of all active uniforms, so they're never queried from the driver again.
+    std::unordered_map<std::string, GLint> uniform_locations;
+    std::vector<GLint> handle_locations;  // by UniformHandle slot
+  };
+  Variant& GetVariant(unsigned features) const;
+  size_t RegisterUniform(const std::string& name) const;
+  // Returns -1 (which setting a uniform ignores) for names that aren't active uniforms.
+  static GLint GetUniformLocation(const Variant& variant, const std::string& name);
+  static void LinkUniformBlock(const Variant& variant, const std::string& name, GLuint binding);
 
-  std::unordered_map<GLenum, GLuint> shader_handles_;
-  GLuint shader_program_;
+  std::unordered_map<GLenum, std::string> shader_filenames_;
+  std::vector<std::string> feedback_varyings_;
+  unsigned supported_features_;
+  // Variants are built lazily, so they're mutable like the rest of the selection state.
+  mutable std::unordered_map<unsigned, Variant> variants_;  // by features
+  mutable Variant* current_variant_;
+  mutable std::vector<std::string> handle_names_;
+  mutable std::vector<std::pair<std::string, GLuint>> uniform_block_bindings_;
 };
 }  // namespace GLOO
 
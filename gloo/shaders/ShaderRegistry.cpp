@@ -0,0 +1,320 @@
+#include "ShaderRegistry.hpp"
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#include <GLFW/glfw3.h>
+
+#include "gloo/utils.hpp"
+#include "gloo/gl_wrapper/GLStateCache.hpp"
+#include "gloo/gl_wrapper/VertexArray.hpp"
+
+// Program binary enums (GL 4.1 / ARB_get_program_binary), which the GL 3.3 loader doesn't define.
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace {
+// Standard vertex attribute names and the fixed locations they're linked to.
+const std::pair<const char*, GLuint> kAttributeLocations[] = {
+    {"vertex_position", GLOO::kPositionAttribLocation},
+    {"vertex_ndc_position", GLOO::kPositionAttribLocation},
+    {"vertex_normal", GLOO::kNormalAttribLocation},
+    {"vertex_tex_coord", GLOO::kTexCoordAttribLocation},
+    {"vertex_color", GLOO::kColorAttribLocation}};
+
+// Marks program cache files, bump the version when changing how programs are built.
+const uint32_t kCacheMagic = 0x42504C47;  // "GLPB"
+const uint32_t kCacheVersion = 1;
+
+void CreateDirectoryIfNotExists(const std::string& directory_path) {
+  struct stat st;
+  if (stat(directory_path.c_str(), &st) == 0) {
+    return;
+  }
+#ifdef _WIN32
+  int result = _mkdir(directory_path.c_str());
+#else
+  int result = mkdir(directory_path.c_str(), 0777);
+#endif
+  if (result != 0) {
+    std::cerr << "Error creating shader cache directory: " << directory_path << std::endl;
+  }
+}
+
+// FNV-1a, which unlike std::hash gives the same file names across runs and platforms.
+uint64_t HashString(const std::string& s, uint64_t hash = 14695981039346656037ull) {
+  for (unsigned char c : s) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string GetGLString(GLenum name) {
+  const GLubyte* value = glGetString(name);
+  return value == nullptr ? "" : reinterpret_cast<const char*>(value);
+}
+}  // namespace
+
+namespace GLOO {
+ShaderRegistry::ShaderRegistry() {}
+
+GLuint ShaderRegistry::Acquire(const std::unordered_map<GLenum, std::string>& shader_filenames,
+                               const std::vector<std::string>& feedback_varyings,
+                               const std::vector<std::string>& defines) {
+  // Sorted by stage, so the key doesn't depend on the hash map's order.
+  std::map<GLenum, std::string> shader_paths(shader_filenames.begin(), shader_filenames.end());
+  std::string key;
+  for (auto& kv : shader_paths) {
+    key += std::to_string(kv.first) + ":" + kv.second + ";";
+  }
+  for (auto& name : feedback_varyings) {
+    key += "varying:" + name + ";";
+  }
+  for (auto& name : defines) {
+    key += "define:" + name + ";";
+  }
+
+  auto it = programs_.find(key);
+  if (it != programs_.end()) {
+    it->second.ref_count++;
+    return it->second.program;
+  }
+
+  std::map<GLenum, std::string> shader_codes;
+  for (auto& kv : shader_paths) {
+    kv.second = GetShaderGLSLDir() + kv.second;
+    std::ifstream ifs(kv.second, std::ifstream::in);
+    shader_codes[kv.first] = std::string(std::istreambuf_iterator<char>{ifs}, {});
+  }
+
+  GLuint program = BuildProgram(key, shader_codes, shader_paths, feedback_varyings, defines);
+  programs_[key] = {program, 1};
+  program_keys_[program] = key;
+  return program;
+}
+
+void ShaderRegistry::Release(GLuint program) {
+  auto key_it = program_keys_.find(program);
+  if (key_it == program_keys_.end()) {
+    return;
+  }
+  auto it = programs_.find(key_it->second);
+  if (--it->second.ref_count > 0) {
+    return;
+  }
+  programs_.erase(it);
+  program_keys_.erase(key_it);
+  GLStateCache::GetInstance().ForgetProgram(program);
+  GL_CHECK(glDeleteProgram(program));
+}
+
+void ShaderRegistry::LoadBinaryFunctions() {
+  if (binary_functions_loaded_) {
+    return;
+  }
+  binary_functions_loaded_ = true;
+
+  bool supported = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1) ||
+                   glfwExtensionSupported("GL_ARB_get_program_binary");
+  if (!supported) {
+    return;
+  }
+  // Some drivers expose the extension without any format they can save.
+  GLint num_formats = 0;
+  GL_CHECK(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats));
+  if (num_formats == 0) {
+    return;
+  }
+
+  auto get_program_binary =
+      reinterpret_cast<GetProgramBinaryProc>(glfwGetProcAddress("glGetProgramBinary"));
+  auto program_binary = reinterpret_cast<ProgramBinaryProc>(glfwGetProcAddress("glProgramBinary"));
+  auto program_parameteri =
+      reinterpret_cast<ProgramParameteriProc>(glfwGetProcAddress("glProgramParameteri"));
+  if (get_program_binary == nullptr || program_binary == nullptr ||
+      program_parameteri == nullptr) {
+    return;
+  }
+  get_program_binary_ = get_program_binary;
+  program_binary_ = program_binary;
+  program_parameteri_ = program_parameteri;
+  CreateDirectoryIfNotExists(GetShaderCacheDir());
+}
+
+GLuint ShaderRegistry::BuildProgram(const std::string& key,
+                                    const std::map<GLenum, std::string>& shader_codes,
+                                    const std::map<GLenum, std::string>& shader_paths,
+                                    const std::vector<std::string>& feedback_varyings,
+                                    const std::vector<std::string>& defines) {
+  LoadBinaryFunctions();
+
+  GLuint program = glCreateProgram();
+  GL_CHECK_ERROR();
+
+  // Binaries only work with the driver that made them, so it's part of the file name.
+  std::string cache_path;
+  if (get_program_binary_ != nullptr) {
+    uint64_t hash = HashString(key + std::to_string(kCacheVersion));
+    for (auto& kv : shader_codes) {
+      hash = HashString(kv.second, hash);
+    }
+    hash = HashString(GetGLString(GL_VENDOR) + GetGLString(GL_RENDERER) + GetGLString(GL_VERSION),
+                      hash);
+    char file_name[32];
+    snprintf(file_name, sizeof(file_name), "%016llx.bin", static_cast<unsigned long long>(hash));
+    cache_path = GetShaderCacheDir() + file_name;
+    if (LoadProgramBinary(cache_path, program)) {
+      return program;
+    }
+  }
+
+  std::vector<GLuint> shader_handles;
+  for (auto& kv : shader_codes) {
+    shader_handles.push_back(
+        LoadShader(kv.first, kv.second, shader_paths.at(kv.first), defines));
+  }
+  for (GLuint handle : shader_handles) {
+    GL_CHECK(glAttachShader(program, handle));
+  }
+
+  if (!feedback_varyings.empty()) {
+    // Varyings have to be declared before linking.
+    std::vector<const char*> varying_names;
+    for (auto& name : feedback_varyings) {
+      varying_names.push_back(name.c_str());
+    }
+    GL_CHECK(glTransformFeedbackVaryings(program, (GLsizei)varying_names.size(),
+                                         varying_names.data(), GL_INTERLEAVED_ATTRIBS));
+  }
+
+  // Attributes declared without an explicit location still get the shared ones, so vertex arrays
+  // don't have to be relinked when switching shaders.
+  for (auto& attribute : kAttributeLocations) {
+    GL_CHECK(glBindAttribLocation(program, attribute.second, attribute.first));
+  }
+  if (program_parameteri_ != nullptr) {
+    GL_CHECK(program_parameteri_(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+  }
+
+  GL_CHECK(glLinkProgram(program));
+  GLint link_status;
+  GL_CHECK(glGetProgramiv(program, GL_LINK_STATUS, &link_status));
+  if (link_status != GL_TRUE) {
+    GLchar err_log_buf[kErrorLogBufferSize];
+    GL_CHECK(glGetProgramInfoLog(program, kErrorLogBufferSize, nullptr, err_log_buf));
+    std::cerr << "Shader linking error: " << err_log_buf << std::endl;
+    return program;
+  }
+
+  // Cleanup after linking.
+  for (GLuint handle : shader_handles) {
+    GL_CHECK(glDetachShader(program, handle));
+    GL_CHECK(glDeleteShader(handle));
+  }
+
+  if (!cache_path.empty()) {
+    StoreProgramBinary(cache_path, program);
+  }
+  return program;
+}
+
+bool ShaderRegistry::LoadProgramBinary(const std::string& cache_path, GLuint program) const {
+  std::ifstream ifs(cache_path, std::ios::binary);
+  if (!ifs) {
+    return false;
+  }
+  uint32_t magic = 0;
+  GLenum format = 0;
+  GLint length = 0;
+  ifs.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  ifs.read(reinterpret_cast<char*>(&format), sizeof(format));
+  ifs.read(reinterpret_cast<char*>(&length), sizeof(length));
+  if (!ifs || magic != kCacheMagic || length <= 0) {
+    return false;
+  }
+  std::vector<char> binary(length);
+  ifs.read(binary.data(), length);
+  if (!ifs) {
+    return false;
+  }
+
+  GL_CHECK(program_binary_(program, format, binary.data(), length));
+  // Drivers reject binaries they can't use anymore, in which case the program is compiled again.
+  GLint link_status;
+  GL_CHECK(glGetProgramiv(program, GL_LINK_STATUS, &link_status));
+  return link_status == GL_TRUE;
+}
+
+void ShaderRegistry::StoreProgramBinary(const std::string& cache_path, GLuint program) const {
+  GLint length = 0;
+  GL_CHECK(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+  if (length <= 0) {
+    return;
+  }
+  std::vector<char> binary(length);
+  GLenum format = 0;
+  GL_CHECK(get_program_binary_(program, length, &length, &format, binary.data()));
+
+  std::ofstream ofs(cache_path, std::ios::binary | std::ios::trunc);
+  if (!ofs) {
+    return;
+  }
+  ofs.write(reinterpret_cast<const char*>(&kCacheMagic), sizeof(kCacheMagic));
+  ofs.write(reinterpret_cast<const char*>(&format), sizeof(format));
+  ofs.write(reinterpret_cast<const char*>(&length), sizeof(length));
+  ofs.write(binary.data(), length);
+}
+
+GLuint ShaderRegistry::LoadShader(GLenum type,
+                                  std::string shader_code,
+                                  const std::string& shader_file_name,
+                                  const std::vector<std::string>& defines) {
+  GLuint shader_handle = glCreateShader(type);
+  GL_CHECK_ERROR();
+  auto version_pos = shader_code.find("#version");
+  if (version_pos == std::string::npos) {
+    throw std::runtime_error("Shader file " + shader_file_name +
+                             " has no #version!");
+  }
+  auto version_end = shader_code.find('\n', version_pos);
+  std::string version =
+      shader_code.substr(version_pos, version_end + 1 - version_pos);
+  shader_code = shader_code.substr(version_end + 1);
+  std::string define_lines = "#define ASSIGNMENT_5_STARTER\n";
+  for (auto& name : defines) {
+    define_lines += "#define " + name + "\n";
+  }
+  std::vector<const char*> codes = {version.c_str(), define_lines.c_str(), shader_code.c_str()};
+  GL_CHECK(glShaderSource(shader_handle, (GLsizei)codes.size(), codes.data(),
+                          nullptr));
+  GL_CHECK(glCompileShader(shader_handle));
+
+  GLint compile_status;
+  GL_CHECK(glGetShaderiv(shader_handle, GL_COMPILE_STATUS, &compile_status));
+  if (compile_status != GL_TRUE) {
+    char err_log_buf[kErrorLogBufferSize];
+    GL_CHECK(glGetShaderInfoLog(shader_handle, kErrorLogBufferSize, nullptr,
+                                err_log_buf));
+    std::cerr << "Shader compilation error: " << err_log_buf << std::endl;
+    return 0;
+  }
+
+  return shader_handle;
+}
+}  // namespace GLOO
@@ -0,0 +1,97 @@
+#ifndef GLOO_SHADER_REGISTRY_H_
+#define GLOO_SHADER_REGISTRY_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace GLOO {
+/**
+ * Process wide registry of linked shader programs, shared by all ShaderPrograms built from the
+ * same shader files, transform feedback varyings and defines. A program is compiled the first time it's
+ * acquired and deleted once the last ShaderProgram using it releases it.
+ *
+ * If the driver supports program binaries (GL 4.1 or ARB_get_program_binary), linked programs are
+ * also written to the shader cache directory (see GetShaderCacheDir), so later runs load them
+ * instead of compiling. Cache files are keyed by the shader sources and the driver, so editing a
+ * shader or updating the driver just falls back to compiling.
+ */
+class ShaderRegistry {
+ public:
+  // Singleton design pattern, like InputManager.
+  static ShaderRegistry& GetInstance() {
+    static ShaderRegistry _instance;
+    return _instance;
+  }
+
+  ShaderRegistry(const ShaderRegistry&) = delete;
+  void operator=(const ShaderRegistry&) = delete;
+
+  // Returns the program linked from `shader_filenames` (relative to the shader directory), with
+  // each of `defines` #defined in every stage. Every call must be matched by a Release() of the
+  // returned program.
+  GLuint Acquire(const std::unordered_map<GLenum, std::string>& shader_filenames,
+                 const std::vector<std::string>& feedback_varyings,
+                 const std::vector<std::string>& defines);
+  void Release(GLuint program);
+
+ private:
+  typedef void(APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei buf_size, GLsizei* length,
+                                               GLenum* binary_format, void* binary);
+  typedef void(APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binary_format,
+                                            const void* binary, GLsizei length);
+  typedef void(APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+  ShaderRegistry();
+  // Loads the program binary entry points the first time a program is built, since they need a
+  // current GL context.
+  void LoadBinaryFunctions();
+  GLuint BuildProgram(const std::string& key, const std::map<GLenum, std::string>& shader_codes,
+                      const std::map<GLenum, std::string>& shader_paths,
+                      const std::vector<std::string>& feedback_varyings,
+                      const std::vector<std::string>& defines);
+  bool LoadProgramBinary(const std::string& cache_path, GLuint program) const;
+  void StoreProgramBinary(const std::string& cache_path, GLuint program) const;
+  static GLuint LoadShader(GLenum type, std::string shader_code, const std::string& shader_filename,
+                           const std::vector<std::string>& defines);
+
+  const static int kErrorLogBufferSize = 512;
+
+  struct Entry {
+    GLuint program;
+    int ref_count;
+  };
+  std::unordered_map<std::string, Entry> programs_;  // by shader files, varyings and defines
+  std::unordered_map<GLuint, std::string> program_keys_;
+
+  bool binary_functions_loaded_ = false;
+  // Null if the driver can't save program binaries.
+  GetProgramBinaryProc get_program_binary_ = nullptr;
+  ProgramBinaryProc program_binary_ = nullptr;
+  ProgramParameteriProc program_parameteri_ = nullptr;
+};
+
+/**
+ * Returns the instance of shader `T` shared by everyone drawing with it, creating it on first use.
+ * Meant for shaders that keep no per-node state (their per-node uniforms are set again in every
+ * SetTargetNode), so nodes don't each pay for a ShaderProgram's uniform lookups and the renderer
+ * can group their draws. The instance is destroyed once its last user releases it, so it never
+ * outlives the GL context.
+ */
+template <class T>
+std::shared_ptr<T> GetSharedShader() {
+  static std::weak_ptr<T> shared;
+  std::shared_ptr<T> shader = shared.lock();
+  if (shader == nullptr) {
+    shader = std::make_shared<T>();
+    shared = shader;
+  }
+  return shader;
+}
+}  // namespace GLOO
+
+#endif
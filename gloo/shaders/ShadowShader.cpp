@@ -21,7 +21,7 @@ void ShadowShader::AssociateVertexArray(VertexArray& vertex_array) const {
   if (!vertex_array.HasPositionBuffer()) {
     throw std::runtime_error("Shadow shader requires vertex positions!");
   }
-  vertex_array.LinkPositionBuffer(GetAttributeLocation("vertex_position"));
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
 }
 
 void ShadowShader::SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const {
@@ -0,0 +1,60 @@
+#include "SilhouetteShader.hpp"
+
+#include <stdexcept>
+
+#include "gloo/InputManager.hpp"
+#include "gloo/SceneNode.hpp"
+#include "gloo/components/CameraComponent.hpp"
+#include "gloo/components/MaterialComponent.hpp"
+#include "gloo/components/RenderingComponent.hpp"
+#include "gloo/shaders/CameraBlock.hpp"
+
+namespace GLOO {
+SilhouetteShader::SilhouetteShader()
+    : ShaderProgram(std::unordered_map<GLenum, std::string>{
+          {GL_VERTEX_SHADER, "silhouette.vert"},
+          {GL_GEOMETRY_SHADER, "silhouette.geom"},
+          {GL_FRAGMENT_SHADER, "outline.frag"}}) {
+  BindUniformBlock("CameraBlock", kCameraBlockBinding);
+  model_matrix_ = GetUniform<glm::mat4>("model_matrix");
+  material_color_ = GetUniform<glm::vec3>("material_color");
+  thickness_ = GetUniform<float>("u_thickness");
+}
+
+void SilhouetteShader::AssociateVertexArray(VertexArray& vertex_array) const {
+  if (!vertex_array.HasPositionBuffer()) {
+    throw std::runtime_error("Silhouette shader requires vertex positions!");
+  }
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+}
+
+void SilhouetteShader::SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const {
+  // Associate the right VAO before rendering.
+  AssociateVertexArray(
+      node.GetComponentPtr<RenderingComponent>()->GetVertexObjectPtr()->GetVertexArray());
+
+  // Set transform.
+  SetUniform(model_matrix_, model_matrix);
+
+  // Set material.
+  MaterialComponent* material_component_ptr = node.GetComponentPtr<MaterialComponent>();
+  const Material* material_ptr;
+  if (material_component_ptr == nullptr) {
+    material_ptr = &Material::GetDefaultNPR();
+  } else {
+    material_ptr = &material_component_ptr->GetMaterial();
+  }
+
+  SetUniform(material_color_, material_ptr->GetOutlineColor());
+  SetUniform(thickness_, material_ptr->GetOutlineThickness());
+}
+
+void SilhouetteShader::SetCamera(const CameraComponent& camera) const {
+  // Update shader using window size
+  glm::ivec2 window_size = InputManager::GetInstance().GetWindowSize();
+  glm::vec2 inverse_window_size = glm::vec2(1. / window_size.x, 1. / window_size.y);
+  SetUniform("u_viewportInvSize", inverse_window_size);
+
+  // The view and projection are read from the camera block the renderer uploads.
+}
+}  // namespace GLOO
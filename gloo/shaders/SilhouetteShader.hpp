@@ -0,0 +1,30 @@
+#ifndef GLOO_SILHOUETTE_SHADER_H
+#define GLOO_SILHOUETTE_SHADER_H
+
+#include "ShaderProgram.hpp"
+
+namespace GLOO {
+/**
+ * Shader that finds and draws silhouette edges on the GPU.
+ *
+ * Meshes are drawn with DrawMode::TrianglesAdjacency. For every front-facing triangle, the
+ * geometry shader emits a thick line (like OutlineShader) along each edge whose neighboring
+ * triangle faces away from the camera. Edges without a neighbor should repeat one of their own
+ * vertices as the adjacent vertex; the degenerate neighbor then never produces a silhouette.
+ */
+class SilhouetteShader : public ShaderProgram {
+ public:
+  SilhouetteShader();
+  void SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const override;
+  void SetCamera(const CameraComponent& camera) const override;
+
+ private:
+  void AssociateVertexArray(VertexArray& vertex_array) const;
+
+  UniformHandle<glm::mat4> model_matrix_;
+  UniformHandle<glm::vec3> material_color_;
+  UniformHandle<float> thickness_;
+};
+}  // namespace GLOO
+
+#endif
@@ -24,7 +24,7 @@ void SimpleShader::AssociateVertexArray(VertexArray& vertex_array) const {
   if (!vertex_array.HasPositionBuffer()) {
     throw std::runtime_error("Simple shader requires vertex positions!");
   }
-  vertex_array.LinkPositionBuffer(GetAttributeLocation("vertex_position"));
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
 }
 
 void SimpleShader::SetTargetNode(const SceneNode& node,
@@ -5,18 +5,23 @@
 #include <stdexcept>
 
 #include "gloo/SceneNode.hpp"
-#include "gloo/components/CameraComponent.hpp"
-#include "gloo/components/LightComponent.hpp"
-#include "gloo/components/MaterialComponent.hpp"
 #include "gloo/components/RenderingComponent.hpp"
-#include "gloo/lights/AmbientLight.hpp"
-#include "gloo/lights/DirectionalLight.hpp"
-#include "gloo/lights/PointLight.hpp"
+#include "gloo/shaders/CameraBlock.hpp"
+#include "gloo/shaders/LightBlock.hpp"
+#include "gloo/shaders/MaterialBlock.hpp"
 
 namespace GLOO {
 ToneMappingShader::ToneMappingShader()
     : ShaderProgram(std::unordered_map<GLenum, std::string>{
-          {GL_VERTEX_SHADER, "tone_mapping.vert"}, {GL_FRAGMENT_SHADER, "tone_mapping.frag"}}) {}
+                        {GL_VERTEX_SHADER, "tone_mapping.vert"},
+                        {GL_FRAGMENT_SHADER, "tone_mapping.frag"}},
+                    {}, kLightFeatures) {
+  BindUniformBlock("LightBlock", kLightBlockBinding);
+  BindUniformBlock("CameraBlock", kCameraBlockBinding);
+  BindUniformBlock("MaterialBlock", kMaterialBlockBinding);
+  model_matrix_ = GetUniform<glm::mat4>("model_matrix");
+  normal_matrix_ = GetUniform<glm::mat3>("normal_matrix");
+}
 
 void ToneMappingShader::AssociateVertexArray(VertexArray& vertex_array) const {
   if (!vertex_array.HasPositionBuffer()) {
@@ -25,13 +30,10 @@ void ToneMappingShader::AssociateVertexArray(VertexArray& vertex_array) const {
   if (!vertex_array.HasNormalBuffer()) {
     throw std::runtime_error("Tone Mapping shader requires vertex normals!");
   }
-  vertex_array.LinkPositionBuffer(GetAttributeLocation("vertex_position"));
-  vertex_array.LinkNormalBuffer(GetAttributeLocation("vertex_normal"));
+  vertex_array.LinkPositionBuffer(kPositionAttribLocation);
+  vertex_array.LinkNormalBuffer(kNormalAttribLocation);
   if (vertex_array.HasTexCoordBuffer()) {
-    GLint loc = GetAttributeLocation("vertex_tex_coord");
-    if (loc != -1) {
-      vertex_array.LinkTexCoordBuffer(loc);
-    }
+    vertex_array.LinkTexCoordBuffer(kTexCoordAttribLocation);
   }
 }
 
@@ -42,71 +44,8 @@ void ToneMappingShader::SetTargetNode(const SceneNode& node, const glm::mat4& mo
 
   // Set transform.
   glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(model_matrix)));
-  SetUniform("model_matrix", model_matrix);
-  SetUniform("normal_matrix", normal_matrix);
-
-  // Set material.
-  MaterialComponent* material_component_ptr = node.GetComponentPtr<MaterialComponent>();
-  const Material* material_ptr;
-  if (material_component_ptr == nullptr) {
-    material_ptr = &Material::GetDefaultNPR();
-  } else {
-    material_ptr = &material_component_ptr->GetMaterial();
-  }
-
-  // Use Material Properties to Set Tone Mapping
-  // TODO: Have some way to use the warm/cool color calculation
-  // for colors as part of some preset?
-  // float b = .8;
-  // float y = .8;
-  // glm::vec3(0, 0, b);
-  // glm::vec3(y, y, 0);
-  SetUniform("material.low_color", material_ptr->GetShadowColor());
-  SetUniform("material.high_color", material_ptr->GetIlluminatedColor());
-
-  SetUniform("material.diffuse_intensity", material_ptr->GetDiffuseIntensity());
-  SetUniform("material.specular_intensity", material_ptr->GetSpecularIntensity());
-  SetUniform("material.shininess", material_ptr->GetShininess());
-}
-
-void ToneMappingShader::SetCamera(const CameraComponent& camera) const {
-  SetUniform("view_matrix", camera.GetViewMatrix());
-  SetUniform("projection_matrix", camera.GetProjectionMatrix());
-  SetUniform("camera_position",
-             glm::vec3(glm::inverse(camera.GetViewMatrix()) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)));
-}
-
-void ToneMappingShader::SetLightSource(const LightComponent& component) const {
-  auto light_ptr = component.GetLightPtr();
-  if (light_ptr == nullptr) {
-    throw std::runtime_error("Light component has no light attached!");
-  }
-
-  // First disable all lights.
-  // In a single rendering pass, only one light of one type is enabled.
-  SetUniform("ambient_light.enabled", false);
-  SetUniform("point_light.enabled", false);
-  SetUniform("directional_light.enabled", false);
-
-  if (light_ptr->GetType() == LightType::Ambient) {
-    auto ambient_light_ptr = static_cast<AmbientLight*>(light_ptr);
-    SetUniform("ambient_light.enabled", true);
-    SetUniform("ambient_light.ambient", ambient_light_ptr->GetAmbientColor());
-  } else if (light_ptr->GetType() == LightType::Point) {
-    auto point_light_ptr = static_cast<PointLight*>(light_ptr);
-    SetUniform("point_light.enabled", true);
-    SetUniform("point_light.position", component.GetNodePtr()->GetTransform().GetPosition());
-    SetUniform("point_light.diffuse", point_light_ptr->GetDiffuseColor());
-    SetUniform("point_light.specular", point_light_ptr->GetSpecularColor());
-    SetUniform("point_light.attenuation", point_light_ptr->GetAttenuation());
-  } else if (light_ptr->GetType() == LightType::Directional) {
-    auto directional_light_ptr = static_cast<DirectionalLight*>(light_ptr);
-    SetUniform("directional_light.enabled", true);
-    SetUniform("directional_light.direction", directional_light_ptr->GetDirection());
-    SetUniform("directional_light.diffuse", directional_light_ptr->GetDiffuseColor());
-    SetUniform("directional_light.specular", directional_light_ptr->GetSpecularColor());
-  } else {
-    throw std::runtime_error("Encountered light type unrecognized by the shader!");
-  }
+  SetUniform(model_matrix_, model_matrix);
+  SetUniform(normal_matrix_, normal_matrix);
+  // The camera and material are read from the uniform blocks the renderer uploads.
 }
 }  // namespace GLOO
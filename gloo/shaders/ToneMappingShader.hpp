@@ -11,11 +11,15 @@ class ToneMappingShader : public ShaderProgram {
  public:
   ToneMappingShader();
   void SetTargetNode(const SceneNode& node, const glm::mat4& model_matrix) const override;
-  void SetCamera(const CameraComponent& camera) const override;
-  void SetLightSource(const LightComponent& component) const override;
+  DeferredShadingModel GetDeferredShadingModel() const override {
+    return DeferredShadingModel::ToneMapping;
+  }
 
  private:
   void AssociateVertexArray(VertexArray& vertex_array) const;
+
+  UniformHandle<glm::mat4> model_matrix_;
+  UniformHandle<glm::mat3> normal_matrix_;
 };
 }  // namespace GLOO
 
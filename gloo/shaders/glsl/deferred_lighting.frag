@@ -0,0 +1,141 @@
+#version 330 core
+
+in vec2 tex_coord;
+out vec4 frag_color;
+
+// Must match LightBlock in gloo/shaders/LightBlock.hpp
+#define MAX_LIGHTS 8
+
+struct Light {
+    vec4 position;
+    vec4 direction;
+    vec4 diffuse; // ambient color for ambient lights
+    vec4 specular;
+    vec4 attenuation;
+    ivec4 info; // (type, uses shadow map, unused, unused)
+};
+
+layout(std140) uniform LightBlock {
+    Light lights[MAX_LIGHTS];
+    ivec4 light_counts; // (ambient, point, directional, unused)
+};
+
+// Must match DeferredShadingModel in gloo/shaders/ShaderProgram.hpp
+#define NO_SHADING_MODEL 0
+#define TONE_MAPPING_MODEL 1
+#define TOON_MODEL 2
+
+// G-buffer written by g_buffer.frag
+uniform sampler2D normal_depth_texture;
+uniform sampler2D low_color_texture;
+uniform sampler2D high_color_texture;
+uniform sampler2D material_texture;
+uniform sampler2D depth_texture;
+
+uniform mat4 inverse_projection_matrix;
+uniform mat4 view_to_world_matrix;
+uniform vec3 camera_position;
+
+float threshold = 0.5; // same as toon_shading.frag
+
+// Surface properties of the current pixel, read from the G-buffer
+int shading_model;
+vec3 world_position;
+vec3 low_color;
+vec3 high_color;
+float diffuse_intensity;
+float specular_intensity;
+float shininess;
+
+vec3 CalcAmbientLight(Light light);
+vec3 CalcPointLight(Light light, vec3 normal, vec3 view_dir);
+vec3 CalcDirectionalLight(Light light, vec3 normal, vec3 view_dir);
+
+void main() {
+    vec2 material = texture(material_texture, tex_coord).rg;
+    shading_model = int(material.g + 0.5);
+    if (shading_model == NO_SHADING_MODEL) {
+        discard;
+    }
+    shininess = material.r;
+    vec4 low = texture(low_color_texture, tex_coord);
+    vec4 high = texture(high_color_texture, tex_coord);
+    low_color = low.rgb;
+    diffuse_intensity = low.a;
+    high_color = high.rgb;
+    specular_intensity = high.a;
+
+    // Rebuild the view space position from the view depth along the pixel's view ray
+    vec4 normal_depth = texture(normal_depth_texture, tex_coord);
+    vec4 ray = inverse_projection_matrix * vec4(2.0 * tex_coord - 1.0, 1.0, 1.0);
+    vec3 view_position = ray.xyz / ray.w;
+    view_position *= normal_depth.a / -view_position.z;
+    world_position = vec3(view_to_world_matrix * vec4(view_position, 1.0));
+
+    vec3 normal = normalize(mat3(view_to_world_matrix) * normal_depth.xyz);
+    vec3 view_dir = normalize(camera_position - world_position);
+
+    vec3 color = vec3(0.0);
+    // Lights are sorted by type, see light_counts
+    int point_begin = light_counts.x;
+    int directional_begin = point_begin + light_counts.y;
+    int light_end = directional_begin + light_counts.z;
+    for (int i = 0; i < point_begin; i++) {
+        color += CalcAmbientLight(lights[i]);
+    }
+    for (int i = point_begin; i < directional_begin; i++) {
+        color += CalcPointLight(lights[i], normal, view_dir);
+    }
+    for (int i = directional_begin; i < light_end; i++) {
+        color += CalcDirectionalLight(lights[i], normal, view_dir);
+    }
+    frag_color = vec4(color, 1.0);
+    gl_FragDepth = texture(depth_texture, tex_coord).r;
+}
+
+float desaturate(vec3 color) {
+    return 0.3 * color.r + 0.59 * color.g + 0.11 * color.b;
+}
+
+// Mixes between the low and high color like tone_mapping.frag or toon_shading.frag
+vec3 MixToneColor(float color_mix_factor) {
+    if (shading_model == TOON_MODEL) {
+        color_mix_factor = step(threshold, color_mix_factor);
+    } else {
+        color_mix_factor = clamp(color_mix_factor, 0, 1);
+    }
+    return mix(low_color, high_color, color_mix_factor);
+}
+
+vec3 CalcAmbientLight(Light light) {
+    return MixToneColor(desaturate(light.diffuse.rgb));
+}
+
+float CalcLightTerm(vec3 light_dir, vec3 normal, vec3 view_dir) {
+    // Matte shading
+    float lambertian_term = dot(normal, light_dir); // from [-1, 1]
+    float diffuse_term = diffuse_intensity * ((1 + lambertian_term) / 2);
+
+    // Specular shading
+    vec3 reflect_dir = reflect(-light_dir, normal);
+    float specular_term = specular_intensity * pow(max(dot(view_dir, reflect_dir), 0.0), shininess);
+    return diffuse_term + specular_term;
+}
+
+vec3 CalcPointLight(Light light, vec3 normal, vec3 view_dir) {
+    vec3 light_dir = normalize(light.position.xyz - world_position);
+
+    // Add in point light attenuation
+    float distance = length(light.position.xyz - world_position);
+    float attenuation = 1.0 / (light.attenuation.x + 
+        light.attenuation.y * distance + 
+        light.attenuation.z * (distance * distance));
+
+    float light_term = attenuation * CalcLightTerm(light_dir, normal, view_dir);
+    return MixToneColor(light_term);
+}
+
+vec3 CalcDirectionalLight(Light light, vec3 normal, vec3 view_dir) {
+    vec3 light_dir = normalize(-light.direction.xyz);
+    return MixToneColor(CalcLightTerm(light_dir, normal, view_dir));
+}
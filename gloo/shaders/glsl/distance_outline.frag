@@ -0,0 +1,27 @@
+#version 330 core
+
+// Output of the last jump flooding pass
+uniform sampler2D seed_texture;
+
+uniform vec3 outline_color;
+uniform float u_thickness;
+
+out vec4 frag_color;
+
+void main() {
+    if (u_thickness <= 0.0) {
+        discard;
+    }
+    vec2 seed = texelFetch(seed_texture, ivec2(gl_FragCoord.xy), 0).xy;
+    if (seed.x < 0.0) {
+        discard;
+    }
+    // Seeds are edge pixels on both sides of a discontinuity, which already span about a pixel
+    float radius = max(0.5 * u_thickness - 0.5, 0.5);
+    // Roughly one pixel of coverage falloff, for smooth round ends and joins
+    float coverage = clamp(radius + 0.5 - distance(seed, gl_FragCoord.xy), 0.0, 1.0);
+    if (coverage <= 0.0) {
+        discard;
+    }
+    frag_color = vec4(outline_color, coverage);
+}
@@ -0,0 +1,39 @@
+#version 330 core
+
+// Edge type bits, see EdgeCompactionShader
+const uint SILHOUETTE_EDGE = 1u;
+const uint CREASE_EDGE = 2u;
+const uint BORDER_EDGE = 4u;
+
+uniform usamplerBuffer edge_vertices;
+uniform usamplerBuffer edge_faces;
+uniform usamplerBuffer edge_types;
+uniform samplerBuffer face_planes;
+
+uniform vec3 eye_position;
+uniform float cos_crease_threshold;
+uniform int shown_types;
+
+// One vertex per edge (gl_VertexID is the edge id)
+flat out uvec2 vertex_indices;
+flat out int visible;
+
+void main() {
+    uint possible_types = texelFetch(edge_types, gl_VertexID).r;
+    uint types = possible_types & BORDER_EDGE;
+    if ((possible_types & (SILHOUETTE_EDGE | CREASE_EDGE)) != 0u) {
+        uvec2 faces = texelFetch(edge_faces, gl_VertexID).rg;
+        vec4 plane0 = texelFetch(face_planes, int(faces.x));
+        vec4 plane1 = texelFetch(face_planes, int(faces.y));
+        vec4 eye = vec4(eye_position, 1.0);
+        if ((dot(plane0, eye) >= 0.0) != (dot(plane1, eye) >= 0.0)) {
+            types |= SILHOUETTE_EDGE;
+        }
+        if (dot(plane0.xyz, plane1.xyz) < cos_crease_threshold) {
+            types |= CREASE_EDGE;
+        }
+        types &= possible_types;
+    }
+    vertex_indices = texelFetch(edge_vertices, gl_VertexID).rg;
+    visible = (types & uint(shown_types)) != 0u ? 1 : 0;
+}
@@ -0,0 +1,56 @@
+#version 330 core
+
+in vec2 tex_coord;
+out vec4 frag_color;
+
+// View space normal in rgb and view space depth in a, with a depth of 0 where there's no surface
+uniform sampler2D normal_depth_texture;
+uniform vec2 u_texelSize;
+
+uniform vec3 outline_color;
+uniform float u_thickness;
+uniform bool depth_edges;
+uniform bool normal_edges;
+uniform float cos_crease_threshold;
+// Depth differences above this fraction of the nearer depth count as silhouettes
+uniform float depth_threshold = 0.05;
+// Write the window coordinates of edge pixels instead of the outline color (seeds for jump_flood)
+uniform bool write_seeds = false;
+
+float getDepth(vec4 normal_depth) {
+    return normal_depth.a > 0.0 ? normal_depth.a : 1e20;
+}
+
+bool isCrease(vec4 a, vec4 b) {
+    return a.a > 0.0 && b.a > 0.0 && dot(a.xyz, b.xyz) < cos_crease_threshold;
+}
+
+void main() {
+    if (u_thickness <= 0.0) {
+        discard;
+    }
+    // Roberts cross over the diagonal neighbors, half a line width away from the pixel
+    vec2 offset = max(0.5 * u_thickness, 0.5) * u_texelSize;
+    vec4 s00 = texture(normal_depth_texture, tex_coord + vec2(-offset.x, -offset.y));
+    vec4 s11 = texture(normal_depth_texture, tex_coord + vec2(offset.x, offset.y));
+    vec4 s10 = texture(normal_depth_texture, tex_coord + vec2(offset.x, -offset.y));
+    vec4 s01 = texture(normal_depth_texture, tex_coord + vec2(-offset.x, offset.y));
+
+    bool edge = false;
+    if (depth_edges) {
+        float d00 = getDepth(s00);
+        float d11 = getDepth(s11);
+        float d10 = getDepth(s10);
+        float d01 = getDepth(s01);
+        float nearest = min(min(d00, d11), min(d10, d01));
+        float difference = max(abs(d00 - d11), abs(d10 - d01));
+        edge = nearest < 1e20 && difference > depth_threshold * nearest;
+    }
+    if (normal_edges) {
+        edge = edge || isCrease(s00, s11) || isCrease(s10, s01);
+    }
+    if (!edge) {
+        discard;
+    }
+    frag_color = write_seeds ? vec4(gl_FragCoord.xy, 0.0, 1.0) : vec4(outline_color, 1.0);
+}
@@ -0,0 +1,31 @@
+#version 330 core
+
+// Must match MaterialBlock in gloo/shaders/MaterialBlock.hpp
+layout(std140) uniform MaterialBlock {
+    vec3 ambient_color;
+    float shininess;
+    vec3 diffuse_color;
+    float diffuse_intensity;
+    vec3 specular_color;
+    float specular_intensity;
+    vec3 illuminated_color; // NPR high color
+    vec3 shadow_color; // NPR low color
+} material;
+
+in vec3 view_position;
+in vec3 view_normal;
+
+uniform int shading_model;
+
+// Same layout as normal_depth.frag, cleared to 0 where there's no surface
+layout(location = 0) out vec4 frag_normal_depth;
+layout(location = 1) out vec4 frag_low_color; // low color, diffuse intensity
+layout(location = 2) out vec4 frag_high_color; // high color, specular intensity
+layout(location = 3) out vec2 frag_material; // shininess, shading model (0 where there's no surface)
+
+void main() {
+    frag_normal_depth = vec4(normalize(view_normal), -view_position.z);
+    frag_low_color = vec4(material.shadow_color, material.diffuse_intensity);
+    frag_high_color = vec4(material.illuminated_color, material.specular_intensity);
+    frag_material = vec2(material.shininess, float(shading_model));
+}
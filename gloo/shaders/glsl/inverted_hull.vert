@@ -0,0 +1,31 @@
+#version 330 core
+
+uniform mat4 model_matrix;
+uniform mat3 normal_matrix;
+// Must match CameraBlock in gloo/shaders/CameraBlock.hpp
+layout(std140) uniform CameraBlock {
+    mat4 view_matrix;
+    mat4 projection_matrix;
+    vec3 camera_position;
+};
+
+uniform vec2    u_viewportInvSize; // 1/viewportSize
+uniform float   u_thickness = 4;
+
+layout(location = 0) in vec3 vertex_position;
+layout(location = 1) in vec3 vertex_normal;
+
+void main() {
+    mat4 view_projection = projection_matrix * view_matrix;
+    vec4 clip_position = view_projection * model_matrix * vec4(vertex_position, 1.0);
+    vec3 world_normal = normal_matrix * vertex_normal;
+    vec2 screen_normal = (view_projection * vec4(world_normal, 0.0)).xy;
+
+    // Push the vertex out by u_thickness pixels (scaled by w, so the width doesn't shrink with
+    // depth). Normals pointing straight at the camera don't move the outline, so they stay put.
+    if (dot(screen_normal, screen_normal) > 1e-12) {
+        clip_position.xy += normalize(screen_normal) * 2.0 * u_thickness * u_viewportInvSize *
+                            clip_position.w;
+    }
+    gl_Position = clip_position;
+}
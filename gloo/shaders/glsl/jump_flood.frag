@@ -0,0 +1,29 @@
+#version 330 core
+
+// Window coordinates of the nearest seed found so far, negative where there's none
+uniform sampler2D seed_texture;
+uniform int u_step;
+
+out vec4 nearest_seed;
+
+void main() {
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    ivec2 max_pixel = textureSize(seed_texture, 0) - 1;
+    vec2 best_seed = vec2(-1.0);
+    float best_distance = 1e20;
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            ivec2 neighbor = clamp(pixel + ivec2(x, y) * u_step, ivec2(0), max_pixel);
+            vec2 seed = texelFetch(seed_texture, neighbor, 0).xy;
+            if (seed.x < 0.0) {
+                continue;
+            }
+            float seed_distance = distance(seed, gl_FragCoord.xy);
+            if (seed_distance < best_distance) {
+                best_distance = seed_distance;
+                best_seed = seed;
+            }
+        }
+    }
+    nearest_seed = vec4(best_seed, 0.0, 1.0);
+}
@@ -2,31 +2,22 @@
 // TODO: try modified version with geometry shader shown here: https://blog.scottlogic.com/2019/11/18/drawing-lines-with-webgl.html
 #version 330 core
 
-layout (std140) uniform TVertex {
-    vec4 vertex[1024];
-};
-
-uniform mat4 model_matrix;
-uniform mat4 view_matrix;
-uniform mat4 model_view_project_matrix;
-uniform mat4 projection_matrix;
+// Polyline points already projected by PointProjectionShader, as
+// (window x, window y, NDC z, clip w).
+uniform samplerBuffer projected_points;
+
 uniform vec2  u_resolution;
 uniform float u_thickness;
 
 void main()
 {
-    mat4 u_mvp = projection_matrix * view_matrix * model_matrix;
     int line_i = gl_VertexID / 6;
     int tri_i  = gl_VertexID % 6;
 
     vec4 va[4];
     for (int i=0; i<4; ++i)
     {
-        vec3 world_position = vec3(model_matrix * vertex[line_i + i]);
-        va[i] = projection_matrix * view_matrix * vec4(world_position, 1.0);
-
-        va[i].xyz /= va[i].w;
-        va[i].xy = (va[i].xy + 1.0) * 0.5 * u_resolution;
+        va[i] = texelFetch(projected_points, line_i + i);
     }
 
     vec2 v_line  = normalize(va[2].xy - va[1].xy);
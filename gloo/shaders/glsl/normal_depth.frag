@@ -0,0 +1,11 @@
+#version 330 core
+
+in vec3 view_position;
+in vec3 view_normal;
+
+// Cleared to 0, so a depth of 0 marks pixels without any surface
+out vec4 frag_normal_depth;
+
+void main() {
+    frag_normal_depth = vec4(normalize(view_normal), -view_position.z);
+}
@@ -1,8 +1,12 @@
 #version 330 core
 
 uniform mat4 model_matrix;
-uniform mat4 view_matrix;
-uniform mat4 projection_matrix;
+// Must match CameraBlock in gloo/shaders/CameraBlock.hpp
+layout(std140) uniform CameraBlock {
+    mat4 view_matrix;
+    mat4 projection_matrix;
+    vec3 camera_position;
+};
 
 layout(location = 0) in vec3 vertex_position;
 
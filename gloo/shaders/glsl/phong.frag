@@ -2,114 +2,135 @@
 
 out vec4 frag_color;
 
-struct AmbientLight {
-    bool enabled;
-    vec3 ambient;
+// Must match LightBlock in gloo/shaders/LightBlock.hpp
+#define MAX_LIGHTS 8
+
+struct Light {
+    vec4 position;
+    vec4 direction;
+    vec4 diffuse; // ambient color for ambient lights
+    vec4 specular;
+    vec4 attenuation;
+    ivec4 info; // (type, uses shadow map, unused, unused)
 };
 
-struct PointLight {
-    bool enabled;
-    vec3 position;
-    vec3 diffuse;
-    vec3 specular;
-    vec3 attenuation;
+layout(std140) uniform LightBlock {
+    Light lights[MAX_LIGHTS];
+    ivec4 light_counts; // (ambient, point, directional, unused)
 };
 
-struct DirectionalLight {
-    bool enabled;
-    vec3 direction;
-    vec3 diffuse;
-    vec3 specular;
-    mat4 world_to_light_ndc_matrix;
-    sampler2D shadow_map;
-    float shadow_bias;
-};
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    sampler2D diffuse_sampler;
-    sampler2D specular_sampler;
-    sampler2D ambient_sampler;
+// Must match MaterialBlock in gloo/shaders/MaterialBlock.hpp
+layout(std140) uniform MaterialBlock {
+    vec3 ambient_color;
     float shininess;
-};
+    vec3 diffuse_color;
+    float diffuse_intensity;
+    vec3 specular_color;
+    float specular_intensity;
+    vec3 illuminated_color; // NPR high color
+    vec3 shadow_color; // NPR low color
+} material;
 
 in vec3 world_position;
 in vec3 world_normal;
 in vec2 tex_coord;
-// Controls the use of textures on each shading component
-uniform bool diffuse_use_texture;
-uniform bool specular_use_texture;
-uniform bool ambient_use_texture;
-
-uniform vec3 camera_position;
+// Textures of each shading component, compiled in only for materials that have them
+#ifdef DIFFUSE_TEXTURE
+uniform sampler2D diffuse_sampler;
+#endif
+#ifdef SPECULAR_TEXTURE
+uniform sampler2D specular_sampler;
+#endif
+#ifdef AMBIENT_TEXTURE
+uniform sampler2D ambient_sampler;
+#endif
+
+// Must match CameraBlock in gloo/shaders/CameraBlock.hpp
+layout(std140) uniform CameraBlock {
+    mat4 view_matrix;
+    mat4 projection_matrix;
+    vec3 camera_position;
+};
 
-uniform Material material; // material properties of the object
-uniform AmbientLight ambient_light;
-uniform PointLight point_light; 
-uniform DirectionalLight directional_light;
-vec3 CalcAmbientLight();
-vec3 CalcPointLight(vec3 normal, vec3 view_dir);
-vec3 CalcDirectionalLight(vec3 normal, vec3 view_dir);
+#ifdef SHADOW_MAP
+// Shadow map of the light flagged in info.y, there is at most one per pass
+uniform sampler2D shadow_map;
+uniform mat4 world_to_light_ndc_matrix;
+uniform float shadow_bias;
+#endif
+vec3 CalcAmbientLight(Light light);
+vec3 CalcPointLight(Light light, vec3 normal, vec3 view_dir);
+vec3 CalcDirectionalLight(Light light, vec3 normal, vec3 view_dir);
 
 void main() {
     vec3 normal = normalize(world_normal);
     vec3 view_dir = normalize(camera_position - world_position);
 
-    frag_color = vec4(0.0);
-
-    if (ambient_light.enabled) {
-        frag_color += vec4(CalcAmbientLight(), 1.0);
+    vec3 color = vec3(0.0);
+    // Lights are sorted by type, see light_counts. Each loop is only compiled into the variants
+    // for passes that have lights of its type.
+    int point_begin = light_counts.x;
+    int directional_begin = point_begin + light_counts.y;
+    int light_end = directional_begin + light_counts.z;
+#ifdef AMBIENT_LIGHTS
+    for (int i = 0; i < point_begin; i++) {
+        color += CalcAmbientLight(lights[i]);
     }
-    
-    if (point_light.enabled) {
-        frag_color += vec4(CalcPointLight(normal, view_dir), 1.0);
+#endif
+#ifdef POINT_LIGHTS
+    for (int i = point_begin; i < directional_begin; i++) {
+        color += CalcPointLight(lights[i], normal, view_dir);
     }
-
-    if (directional_light.enabled) {
-        frag_color += vec4(CalcDirectionalLight(normal, view_dir), 1.0);
+#endif
+#ifdef DIRECTIONAL_LIGHTS
+    for (int i = directional_begin; i < light_end; i++) {
+        color += CalcDirectionalLight(lights[i], normal, view_dir);
     }
+#endif
+    frag_color = vec4(color, 1.0);
 }
 
 vec3 GetAmbientColor() {
-    if (ambient_use_texture) {
-        return texture(material.ambient_sampler, tex_coord).rgb;
-    }
-    return material.ambient;
+#ifdef AMBIENT_TEXTURE
+    return texture(ambient_sampler, tex_coord).rgb;
+#else
+    return material.ambient_color;
+#endif
 }
 
 vec3 GetDiffuseColor() {
-    if (diffuse_use_texture) {
-        return texture(material.diffuse_sampler, tex_coord).rgb;
-    }
-    return material.diffuse;
+#ifdef DIFFUSE_TEXTURE
+    return texture(diffuse_sampler, tex_coord).rgb;
+#else
+    return material.diffuse_color;
+#endif
 }
 
 vec3 GetSpecularColor() {
-    if (specular_use_texture) {
-        return texture(material.specular_sampler, tex_coord).rgb;
-    }
-    return material.specular;
+#ifdef SPECULAR_TEXTURE
+    return texture(specular_sampler, tex_coord).rgb;
+#else
+    return material.specular_color;
+#endif
 }
 
-vec3 CalcAmbientLight() {
-    return ambient_light.ambient * GetAmbientColor();
+vec3 CalcAmbientLight(Light light) {
+    return light.diffuse.rgb * GetAmbientColor();
 }
 
-vec3 CalcPointLight(vec3 normal, vec3 view_dir) {
-    PointLight light = point_light;
-    vec3 light_dir = normalize(light.position - world_position);
+vec3 CalcPointLight(Light light, vec3 normal, vec3 view_dir) {
+    vec3 light_dir = normalize(light.position.xyz - world_position);
 
     float diffuse_intensity = max(dot(normal, light_dir), 0.0);
-    vec3 diffuse_color = diffuse_intensity * light.diffuse * GetDiffuseColor();
+    vec3 diffuse_color = diffuse_intensity * light.diffuse.rgb * GetDiffuseColor();
 
     vec3 reflect_dir = reflect(-light_dir, normal);
     float specular_intensity = pow(
         max(dot(view_dir, reflect_dir), 0.0), material.shininess);
     vec3 specular_color = specular_intensity * 
-        light.specular * GetSpecularColor();
+        light.specular.rgb * GetSpecularColor();
 
-    float distance = length(light.position - world_position);
+    float distance = length(light.position.xyz - world_position);
     float attenuation = 1.0 / (light.attenuation.x + 
         light.attenuation.y * distance + 
         light.attenuation.z * (distance * distance));
@@ -117,46 +138,47 @@ vec3 CalcPointLight(vec3 normal, vec3 view_dir) {
     return attenuation * (diffuse_color + specular_color);
 }
 
-vec3 CalcDirectionalLight(vec3 normal, vec3 view_dir) {
+vec3 CalcDirectionalLight(Light light, vec3 normal, vec3 view_dir) {
     // Do check for shadows
     float shadow = 0;
-    // Get normalized device coordinates of world position in light that range from [-1, 1]
-    vec3 light_ndc_point_pos = vec3(directional_light.world_to_light_ndc_matrix * vec4(world_position, 1.0));
+#ifdef SHADOW_MAP
+    if (light.info.y != 0) {
+        // Get normalized device coordinates of world position in light that range from [-1, 1]
+        vec3 light_ndc_point_pos = vec3(world_to_light_ndc_matrix * vec4(world_position, 1.0));
     
-    // Convert ndc to texture coordinates that range from [0, 1]
-    vec3 light_tex_point_pos = 0.5 * light_ndc_point_pos + 0.5;
+        // Convert ndc to texture coordinates that range from [0, 1]
+        vec3 light_tex_point_pos = 0.5 * light_ndc_point_pos + 0.5;
     
-    // Get Depth of current point and the occluder in the shadow map texture
-    float point_depth = light_tex_point_pos.z;
-    // Do percentage closer filtering
-    // Algorithm adapted from LearnOpenGL: https://learnopengl.com/Advanced-Lighting/Shadows/Shadow-Mapping
-    int pcf_size = 2; // 5x5 filter
-    vec2 texelSize = 1.0 / textureSize(directional_light.shadow_map, 0);
-    // Sample a square of points around fragment
-    for (int x = -pcf_size; x <= pcf_size; x++) {
-        for (int y = -pcf_size; y <= pcf_size; y++) {
-            // Check if point is in shadow
-            float occluder_depth = texture(directional_light.shadow_map, light_tex_point_pos.xy + vec2(x, y) * texelSize).r;
-            if (occluder_depth + directional_light.shadow_bias < point_depth) {
-                shadow += 1; // No color from directional light at that point
-            }
-        }   
+        // Get Depth of current point and the occluder in the shadow map texture
+        float point_depth = light_tex_point_pos.z;
+        // Do percentage closer filtering
+        // Algorithm adapted from LearnOpenGL: https://learnopengl.com/Advanced-Lighting/Shadows/Shadow-Mapping
+        int pcf_size = 2; // 5x5 filter
+        vec2 texelSize = 1.0 / textureSize(shadow_map, 0);
+        // Sample a square of points around fragment
+        for (int x = -pcf_size; x <= pcf_size; x++) {
+            for (int y = -pcf_size; y <= pcf_size; y++) {
+                // Check if point is in shadow
+                float occluder_depth = texture(shadow_map, light_tex_point_pos.xy + vec2(x, y) * texelSize).r;
+                if (occluder_depth + shadow_bias < point_depth) {
+                    shadow += 1; // No color from directional light at that point
+                }
+            }   
+        }
+        shadow /= pow((pcf_size * 2 + 1), 2);
     }
-    shadow /= pow((pcf_size * 2 + 1), 2);
+#endif
 
     // Shade normally
-    // Note: I don't use a `light` local variable here because OpenGL gets mad
-    // if a sampler2D (or any opaque type) is part of a struct that's 
-    // used in a non-uniform way
-    vec3 light_dir = normalize(-directional_light.direction);
+    vec3 light_dir = normalize(-light.direction.xyz);
     float diffuse_intensity = max(dot(normal, light_dir), 0.0);
-    vec3 diffuse_color = diffuse_intensity * directional_light.diffuse * GetDiffuseColor();
+    vec3 diffuse_color = diffuse_intensity * light.diffuse.rgb * GetDiffuseColor();
 
     vec3 reflect_dir = reflect(-light_dir, normal);
     float specular_intensity = pow(
         max(dot(view_dir, reflect_dir), 0.0), material.shininess);
     vec3 specular_color = specular_intensity * 
-        directional_light.specular * GetSpecularColor();
+        light.specular.rgb * GetSpecularColor();
 
     vec3 final_color = diffuse_color + specular_color;
     return (1 - shadow) * final_color;
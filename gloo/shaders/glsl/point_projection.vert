@@ -0,0 +1,16 @@
+#version 330 core
+
+uniform mat4 model_view_projection_matrix;
+uniform vec2 u_resolution;
+
+layout(location = 0) in vec3 vertex_position;
+
+// (window x, window y, NDC z, clip w), captured with transform feedback
+out vec4 projected_position;
+
+void main() {
+    vec4 clip_position = model_view_projection_matrix * vec4(vertex_position, 1.0);
+    vec3 ndc_position = clip_position.xyz / clip_position.w;
+    projected_position = vec4((ndc_position.xy + 1.0) * 0.5 * u_resolution, ndc_position.z,
+                              clip_position.w);
+}
@@ -0,0 +1,19 @@
+#version 330 core
+
+uniform mat4 model_matrix;
+// Must match CameraBlock in gloo/shaders/CameraBlock.hpp
+layout(std140) uniform CameraBlock {
+    mat4 view_matrix;
+    mat4 projection_matrix;
+    vec3 camera_position;
+};
+
+layout(location = 0) in vec3 vertex_position;
+
+out vec3 view_position;
+
+void main() {
+    vec4 position = view_matrix * model_matrix * vec4(vertex_position, 1.0);
+    view_position = position.xyz;
+    gl_Position = projection_matrix * position;
+}
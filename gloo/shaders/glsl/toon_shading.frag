@@ -2,69 +2,78 @@
 
 out vec4 frag_color;
 
-struct AmbientLight {
-    bool enabled;
-    vec3 ambient;
+// Must match LightBlock in gloo/shaders/LightBlock.hpp
+#define MAX_LIGHTS 8
+
+struct Light {
+    vec4 position;
+    vec4 direction;
+    vec4 diffuse; // ambient color for ambient lights
+    vec4 specular;
+    vec4 attenuation;
+    ivec4 info; // (type, uses shadow map, unused, unused)
 };
 
-struct PointLight {
-    bool enabled;
-    vec3 position;
-    vec3 diffuse;
-    vec3 specular;
-    vec3 attenuation;
+layout(std140) uniform LightBlock {
+    Light lights[MAX_LIGHTS];
+    ivec4 light_counts; // (ambient, point, directional, unused)
 };
 
-struct DirectionalLight {
-    bool enabled;
-    vec3 direction;
-    vec3 diffuse;
-    vec3 specular;
-    mat4 world_to_light_ndc_matrix;
-    sampler2D shadow_map;
-    float shadow_bias;
-};
-struct Material {
-    vec3 shadow_color;
-    vec3 illuminated_color;
+// Must match MaterialBlock in gloo/shaders/MaterialBlock.hpp
+layout(std140) uniform MaterialBlock {
+    vec3 ambient_color;
     float shininess;
-    float specular_intensity;
+    vec3 diffuse_color;
     float diffuse_intensity;
-};
+    vec3 specular_color;
+    float specular_intensity;
+    vec3 illuminated_color; // NPR high color
+    vec3 shadow_color; // NPR low color
+} material;
 
 in vec3 world_position;
 in vec3 world_normal;
 in vec2 tex_coord;
 
-uniform vec3 camera_position;
+// Must match CameraBlock in gloo/shaders/CameraBlock.hpp
+layout(std140) uniform CameraBlock {
+    mat4 view_matrix;
+    mat4 projection_matrix;
+    vec3 camera_position;
+};
 
-uniform Material material; // material properties of the object
-uniform AmbientLight ambient_light;
-uniform PointLight point_light; 
-uniform DirectionalLight directional_light;
 float threshold = 0.5; // TODO make uniform shader parameter?
-vec3 CalcAmbientLight();
-vec3 CalcPointLight(vec3 normal, vec3 view_dir);
-vec3 CalcDirectionalLight(vec3 normal, vec3 view_dir);
+vec3 CalcAmbientLight(Light light);
+vec3 CalcPointLight(Light light, vec3 normal, vec3 view_dir);
+vec3 CalcDirectionalLight(Light light, vec3 normal, vec3 view_dir);
 
 void main() {
     // TODO: integrate ambient lights as seen in paper
     vec3 normal = normalize(world_normal);
     vec3 view_dir = normalize(camera_position - world_position);
 
-    frag_color = vec4(0.0);
-
-    if (ambient_light.enabled) {
-        frag_color += vec4(CalcAmbientLight(), 1.0);
+    vec3 color = vec3(0.0);
+    // Lights are sorted by type, see light_counts. Each loop is only compiled into the variants
+    // for passes that have lights of its type.
+    int point_begin = light_counts.x;
+    int directional_begin = point_begin + light_counts.y;
+    int light_end = directional_begin + light_counts.z;
+#ifdef AMBIENT_LIGHTS
+    for (int i = 0; i < point_begin; i++) {
+        color += CalcAmbientLight(lights[i]);
     }
-    
-    if (point_light.enabled) {
-        frag_color += vec4(CalcPointLight(normal, view_dir), 1.0);
+#endif
+#ifdef POINT_LIGHTS
+    for (int i = point_begin; i < directional_begin; i++) {
+        color += CalcPointLight(lights[i], normal, view_dir);
     }
-
-    if (directional_light.enabled) {
-        frag_color += vec4(CalcDirectionalLight(normal, view_dir), 1.0);
+#endif
+#ifdef DIRECTIONAL_LIGHTS
+    for (int i = directional_begin; i < light_end; i++) {
+        color += CalcDirectionalLight(lights[i], normal, view_dir);
     }
+#endif
+    frag_color = vec4(color, 1.0);
 }
 
 
@@ -105,14 +114,13 @@ vec3 GetShadowColor() {
     return material.shadow_color;
 }
 
-vec3 CalcAmbientLight() {
-    return mix(GetShadowColor(), GetIlluminatedColor(), step(threshold, desaturate(ambient_light.ambient)));
+vec3 CalcAmbientLight(Light light) {
+    return mix(GetShadowColor(), GetIlluminatedColor(), step(threshold, desaturate(light.diffuse.rgb)));
     
 }
 
-vec3 CalcPointLight(vec3 normal, vec3 view_dir) {
-    PointLight light = point_light;
-    vec3 light_dir = normalize(light.position - world_position);
+vec3 CalcPointLight(Light light, vec3 normal, vec3 view_dir) {
+    vec3 light_dir = normalize(light.position.xyz - world_position);
     
     // Matte shading
     float lambertian_term = dot(normal, light_dir); // from [-1, 1]
@@ -123,7 +131,7 @@ vec3 CalcPointLight(vec3 normal, vec3 view_dir) {
     float specular_term = GetSpecularIntensity() * pow(max(dot(view_dir, reflect_dir), 0.0), GetShininess());
 
     // Add in point light attenuation
-    float distance = length(light.position - world_position);
+    float distance = length(light.position.xyz - world_position);
     float attenuation = 1.0 / (light.attenuation.x + 
         light.attenuation.y * distance + 
         light.attenuation.z * (distance * distance));
@@ -135,9 +143,9 @@ vec3 CalcPointLight(vec3 normal, vec3 view_dir) {
     return tone_color;
 }
 
-vec3 CalcDirectionalLight(vec3 normal, vec3 view_dir) {
+vec3 CalcDirectionalLight(Light light, vec3 normal, vec3 view_dir) {
     // Shade using Tone Mapping
-    vec3 light_dir = normalize(-directional_light.direction);
+    vec3 light_dir = normalize(-light.direction.xyz);
     // Matte shading
     float lambertian_term = dot(normal, light_dir); // from [-1, 1]
     float diffuse_term = GetDiffuseIntensity() * ((1 + lambertian_term) / 2);
@@ -9,6 +9,7 @@ namespace GLOO {
 std::string project_executable_dir_ = "";
 std::string project_shader_dir_ = "";
 std::string project_asset_dir_ = "";
+std::string project_shader_cache_dir_ = "";
 
 std::vector<std::string> Split(const std::string& s, char delim) {
   std::stringstream ss(s);
@@ -74,6 +75,9 @@ void UpdateRelativePathsFromConfig() {
     } else if (key == "assets") {
       project_asset_dir_ = value;
       std::cout << "Project asset dir: " << project_asset_dir_ << std::endl;
+    } else if (key == "shader_cache") {
+      project_shader_cache_dir_ = value;
+      std::cout << "Project shader cache dir: " << project_shader_cache_dir_ << std::endl;
     }
   }
 }
@@ -104,6 +108,14 @@ std::string GetShaderGLSLDir() {
   return GetProjectRootDir() + shader_dir;
 }
 
+std::string GetShaderCacheDir() {
+  // Use global shader cache directory if we have it, or go with default
+  std::string default_path = "shader_cache/";
+  std::string cache_dir =
+      !project_shader_cache_dir_.empty() ? project_shader_cache_dir_ : default_path;
+  return GetProjectRootDir() + cache_dir;
+}
+
 std::string GetAssetDir() {
   // Use global asset directory if we have it, or go with default
   std::string default_path = "assets/";
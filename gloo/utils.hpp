@@ -50,12 +50,15 @@ std::string GetBasePath(const std::string& path);
 extern std::string project_executable_dir_;  // Set by main
 extern std::string project_shader_dir_;      // From gloo.cfg
 extern std::string project_asset_dir_;       // From gloo.cfg
+extern std::string project_shader_cache_dir_;  // From gloo.cfg
 void SetProjectExecutableDir(std::string path);
 // after establishing the root directory, this function allows us to set the relative paths for the
 // other directories like assets/shaders by reading the gloo.cfg file.
 void UpdateRelativePathsFromConfig();
 std::string GetProjectRootDir();
 std::string GetShaderGLSLDir();
+// Where linked shader program binaries are cached between runs.
+std::string GetShaderCacheDir();
 std::string GetAssetDir();
 std::string GetModelDir();
 std::string GetRenderDir();
@@ -0,0 +1,41 @@
+#include "CreaseIndex.hpp"
+
+#include <algorithm>
+
+namespace GLOO {
+void CreaseIndex::Build(const EdgeTopology& topology) {
+  // Only edges between two faces can be creases. Degenerate faces give NaN cosines, which never
+  // compare below a threshold, so those edges are left out as well.
+  size_t num_edges = topology.GetNumEdges();
+  sorted_edges_.clear();
+  for (size_t e = 0; e < num_edges; e++) {
+    float dihedral_cos = topology.GetEdgeDihedralCos(e);
+    if (topology.GetEdgeFaceCount(e) == 2 && dihedral_cos == dihedral_cos) {
+      sorted_edges_.push_back(static_cast<uint32_t>(e));
+    }
+  }
+  std::stable_sort(sorted_edges_.begin(), sorted_edges_.end(),
+                   [&topology](uint32_t a, uint32_t b) {
+                     return topology.GetEdgeDihedralCos(a) < topology.GetEdgeDihedralCos(b);
+                   });
+  sorted_cos_.resize(sorted_edges_.size());
+  for (size_t i = 0; i < sorted_edges_.size(); i++) {
+    sorted_cos_[i] = topology.GetEdgeDihedralCos(sorted_edges_[i]);
+  }
+  num_creases_ = 0;
+}
+
+void CreaseIndex::SetThreshold(float cos_crease_threshold, std::vector<uint8_t>& edge_flags) {
+  size_t num_creases = std::lower_bound(sorted_cos_.begin(), sorted_cos_.end(),
+                                        cos_crease_threshold) -
+                       sorted_cos_.begin();
+  // Only the edges between the old and new prefix ends change state
+  for (size_t i = num_creases_; i < num_creases; i++) {
+    edge_flags[sorted_edges_[i]] |= kCreaseEdgeBit;
+  }
+  for (size_t i = num_creases; i < num_creases_; i++) {
+    edge_flags[sorted_edges_[i]] &= ~kCreaseEdgeBit;
+  }
+  num_creases_ = num_creases;
+}
+}  // namespace GLOO
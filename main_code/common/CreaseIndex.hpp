@@ -0,0 +1,41 @@
+#ifndef CREASE_INDEX_H_
+#define CREASE_INDEX_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "EdgeTopology.hpp"
+
+namespace GLOO {
+/**
+ * Edges of a mesh sorted by the cosine of their dihedral angle, so crease edges for any threshold
+ * are a prefix of the sorted order.
+ *
+ * Changing the crease threshold becomes a binary search for the new prefix length plus an update
+ * of the crease bits of the edges between the old and new prefix ends, instead of a pass over
+ * every edge.
+ */
+class CreaseIndex {
+ public:
+  // Sorts the edges of `topology` that have two faces by dihedral angle. Resets the threshold so no
+  // edge is marked as a crease.
+  void Build(const EdgeTopology& topology);
+
+  /**
+   * Moves the crease threshold to `cos_crease_threshold` (edges whose dihedral cosine is below it
+   * are creases), setting or clearing kCreaseEdgeBit in `edge_flags` for the edges that changed.
+   */
+  void SetThreshold(float cos_crease_threshold, std::vector<uint8_t>& edge_flags);
+
+  // Crease edges for the current threshold, from the sharpest to the flattest.
+  const uint32_t* GetCreaseEdges() const { return sorted_edges_.data(); }
+  size_t GetNumCreaseEdges() const { return num_creases_; }
+
+ private:
+  std::vector<uint32_t> sorted_edges_;
+  std::vector<float> sorted_cos_;
+  size_t num_creases_ = 0;
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef EDGE_CHAIN_SCRATCH_H_
+#define EDGE_CHAIN_SCRATCH_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace GLOO {
+// CSR adjacency of the vertices referenced by an edge list. Vertices are renumbered densely in
+// ascending order of their mesh index.
+struct EdgeAdjacency {
+  std::vector<uint32_t> vertices;   // mesh index of each local vertex
+  std::vector<uint32_t> offsets;    // neighbors of local vertex v are [offsets[v], offsets[v + 1])
+  std::vector<uint32_t> neighbors;  // local index of the neighbor
+  std::vector<uint32_t> edge_ids;   // index into the edge list of the connecting edge
+};
+
+// Working memory of edgesToPolylines. Keeping one around between calls means chaining stops
+// allocating once its buffers have grown to the largest edge set seen.
+struct EdgeChainScratch {
+  EdgeAdjacency adjacency;
+  std::vector<uint32_t> endpoints;  // local endpoint ids of every edge
+  std::vector<uint32_t> cursor;     // scatter positions while building the adjacency
+  std::vector<uint8_t> used;        // whether each edge is already on a polyline
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,107 @@
+#include "EdgeTopology.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+// One side of an edge: the packed key of the undirected edge plus the face it came from and the
+// edge's slot (3 * face + corner) in that face.
+struct HalfEdge {
+  uint64_t key;
+  uint32_t face;
+  uint32_t slot;
+};
+
+// Packs an undirected edge into a single key with the smaller vertex index in the high 32 bits,
+// so sorting the keys groups every copy of an edge together.
+uint64_t PackEdgeKey(uint32_t a, uint32_t b) {
+  uint32_t lo = std::min(a, b);
+  uint32_t hi = std::max(a, b);
+  return (static_cast<uint64_t>(lo) << 32) | hi;
+}
+}  // namespace
+
+namespace GLOO {
+void EdgeTopology::Build(const PositionArray& positions, const IndexArray& indices) {
+  // Enforce Precondition, we should be dealing with a regular mesh.
+  if (indices.size() % 3 != 0) {
+    throw std::runtime_error("Mesh should be made fully out of triangles!");
+  }
+  size_t num_faces = indices.size() / 3;
+
+  face_vertices_.assign(indices.begin(), indices.end());
+  face_normal_x_.resize(num_faces);
+  face_normal_y_.resize(num_faces);
+  face_normal_z_.resize(num_faces);
+
+  // Compute face normals and emit the three half-edges of each face
+  std::vector<HalfEdge> half_edges(indices.size());
+  for (size_t f = 0; f < num_faces; f++) {
+    uint32_t i1 = indices[3 * f];
+    uint32_t i2 = indices[3 * f + 1];
+    uint32_t i3 = indices[3 * f + 2];
+
+    auto& p1 = positions[i1];
+    auto& p2 = positions[i2];
+    auto& p3 = positions[i3];
+    glm::vec3 normal = glm::normalize(glm::cross(p2 - p1, p3 - p1));
+    face_normal_x_[f] = normal.x;
+    face_normal_y_[f] = normal.y;
+    face_normal_z_[f] = normal.z;
+
+    uint32_t face = static_cast<uint32_t>(f);
+    half_edges[3 * f] = {PackEdgeKey(i1, i2), face, 3 * face};
+    half_edges[3 * f + 1] = {PackEdgeKey(i2, i3), face, 3 * face + 1};
+    half_edges[3 * f + 2] = {PackEdgeKey(i3, i1), face, 3 * face + 2};
+  }
+
+  // Sorting by key puts all faces of an edge next to each other (ties broken by face index so the
+  // edge ordering is deterministic).
+  std::sort(half_edges.begin(), half_edges.end(), [](const HalfEdge& a, const HalfEdge& b) {
+    return a.key < b.key || (a.key == b.key && a.face < b.face);
+  });
+
+  edge_vertices_.clear();
+  edge_faces_.clear();
+  edge_face_counts_.clear();
+  edge_dihedral_cos_.clear();
+  face_edges_.resize(indices.size());
+  // A closed manifold mesh has 1.5 edges per face.
+  edge_face_counts_.reserve(num_faces * 3 / 2 + 1);
+  edge_vertices_.reserve(2 * edge_face_counts_.capacity());
+  edge_faces_.reserve(2 * edge_face_counts_.capacity());
+  edge_dihedral_cos_.reserve(edge_face_counts_.capacity());
+
+  // Collapse each run of equal keys into one edge
+  size_t run_start = 0;
+  while (run_start < half_edges.size()) {
+    uint64_t key = half_edges[run_start].key;
+    size_t run_end = run_start + 1;
+    while (run_end < half_edges.size() && half_edges[run_end].key == key) {
+      run_end++;
+    }
+    size_t run_length = run_end - run_start;
+    uint32_t edge = static_cast<uint32_t>(edge_face_counts_.size());
+    for (size_t i = run_start; i < run_end; i++) {
+      face_edges_[half_edges[i].slot] = edge;
+    }
+
+    edge_vertices_.push_back(static_cast<uint32_t>(key >> 32));
+    edge_vertices_.push_back(static_cast<uint32_t>(key & 0xFFFFFFFF));
+    edge_faces_.push_back(half_edges[run_start].face);
+    edge_faces_.push_back(run_length > 1 ? half_edges[run_start + 1].face : kNoFace);
+    edge_face_counts_.push_back(static_cast<uint8_t>(std::min<size_t>(run_length, 255)));
+    if (run_length == 2) {
+      uint32_t f1 = half_edges[run_start].face;
+      uint32_t f2 = half_edges[run_start + 1].face;
+      edge_dihedral_cos_.push_back(face_normal_x_[f1] * face_normal_x_[f2] +
+                                   face_normal_y_[f1] * face_normal_y_[f2] +
+                                   face_normal_z_[f1] * face_normal_z_[f2]);
+    } else {
+      edge_dihedral_cos_.push_back(1.0f);
+    }
+
+    run_start = run_end;
+  }
+}
+}  // namespace GLOO
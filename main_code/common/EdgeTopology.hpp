@@ -0,0 +1,74 @@
+#ifndef EDGE_TOPOLOGY_H_
+#define EDGE_TOPOLOGY_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "gloo/alias_types.hpp"
+
+namespace GLOO {
+// Marks the missing second face of a border edge.
+const uint32_t kNoFace = 0xFFFFFFFF;
+
+// Bits of the packed per-edge type mask.
+const uint8_t kSilhouetteEdgeBit = 1 << 0;
+const uint8_t kCreaseEdgeBit = 1 << 1;
+const uint8_t kBorderEdgeBit = 1 << 2;
+
+/**
+ * Flat edge/face adjacency of a triangle mesh, built once by sorting packed edge keys.
+ *
+ * Every unique (undirected) edge gets an id in [0, GetNumEdges()). Per-edge data lives in
+ * contiguous arrays indexed by that id: its two vertices (smaller index first), its first two
+ * adjacent faces and the cosine of the dihedral angle between them. Faces store their vertices
+ * and edge ids, and their normals as separate x/y/z arrays so later passes can stream over them.
+ */
+class EdgeTopology {
+ public:
+  // Builds the topology of the triangle list `indices`. Throws if the list isn't made of triangles.
+  void Build(const PositionArray& positions, const IndexArray& indices);
+
+  size_t GetNumEdges() const { return edge_face_counts_.size(); }
+  size_t GetNumFaces() const { return face_normal_x_.size(); }
+
+  uint32_t GetEdgeVertex(size_t edge, int i) const { return edge_vertices_[2 * edge + i]; }
+  // Returns the i-th (0 or 1) face adjacent to `edge`, or kNoFace if it doesn't exist.
+  uint32_t GetEdgeFace(size_t edge, int i) const { return edge_faces_[2 * edge + i]; }
+  // Number of faces sharing `edge` (saturates at 255).
+  uint8_t GetEdgeFaceCount(size_t edge) const { return edge_face_counts_[edge]; }
+  // Cosine of the angle between the normals of the edge's two faces (1 if it doesn't have two).
+  float GetEdgeDihedralCos(size_t edge) const { return edge_dihedral_cos_[edge]; }
+  uint32_t GetFaceVertex(size_t face, int i) const { return face_vertices_[3 * face + i]; }
+  // Returns the edge between the face's vertices i and (i + 1) % 3.
+  uint32_t GetFaceEdge(size_t face, int i) const { return face_edges_[3 * face + i]; }
+  glm::vec3 GetFaceNormal(size_t face) const {
+    return glm::vec3(face_normal_x_[face], face_normal_y_[face], face_normal_z_[face]);
+  }
+
+  const std::vector<uint32_t>& GetEdgeVertices() const { return edge_vertices_; }
+  const std::vector<uint32_t>& GetEdgeFaces() const { return edge_faces_; }
+  const std::vector<uint8_t>& GetEdgeFaceCounts() const { return edge_face_counts_; }
+  const std::vector<float>& GetEdgeDihedralCosines() const { return edge_dihedral_cos_; }
+  const std::vector<uint32_t>& GetFaceVertices() const { return face_vertices_; }
+  const std::vector<float>& GetFaceNormalsX() const { return face_normal_x_; }
+  const std::vector<float>& GetFaceNormalsY() const { return face_normal_y_; }
+  const std::vector<float>& GetFaceNormalsZ() const { return face_normal_z_; }
+
+ private:
+  // 2 entries per edge
+  std::vector<uint32_t> edge_vertices_;
+  std::vector<uint32_t> edge_faces_;
+  // 1 entry per edge
+  std::vector<uint8_t> edge_face_counts_;
+  std::vector<float> edge_dihedral_cos_;
+  // 3 entries per face
+  std::vector<uint32_t> face_vertices_;
+  std::vector<uint32_t> face_edges_;
+  // 1 entry per face (SoA normals)
+  std::vector<float> face_normal_x_;
+  std::vector<float> face_normal_y_;
+  std::vector<float> face_normal_z_;
+};
+}  // namespace GLOO
+
+#endif
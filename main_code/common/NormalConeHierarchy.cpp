@@ -0,0 +1,344 @@
+#include "NormalConeHierarchy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Leaves stop splitting once they have at most this many faces.
+const uint32_t kMaxClusterFaces = 128;
+// Cone tests closer than this to the view plane are treated as mixed, so the exact per-face test
+// decides them.
+const float kConeEpsilon = 1e-4f;
+}  // namespace
+
+namespace GLOO {
+void NormalConeHierarchy::Build(const EdgeTopology& topology, const PositionArray& positions) {
+  uint32_t num_faces = static_cast<uint32_t>(topology.GetNumFaces());
+  nodes_.clear();
+  leaf_nodes_.clear();
+  cluster_faces_.resize(num_faces);
+  face_leaf_.assign(num_faces, 0);
+
+  // Gather centroids and normals used to split faces
+  std::vector<glm::vec3> centroids(num_faces);
+  std::vector<glm::vec3> normals(num_faces);
+  glm::vec3 min_bound(std::numeric_limits<float>::max());
+  glm::vec3 max_bound(-std::numeric_limits<float>::max());
+  for (uint32_t f = 0; f < num_faces; f++) {
+    cluster_faces_[f] = f;
+    centroids[f] = (positions[topology.GetFaceVertex(f, 0)] +
+                    positions[topology.GetFaceVertex(f, 1)] +
+                    positions[topology.GetFaceVertex(f, 2)]) /
+                   3.0f;
+    normals[f] = topology.GetFaceNormal(f);
+    min_bound = glm::min(min_bound, centroids[f]);
+    max_bound = glm::max(max_bound, centroids[f]);
+  }
+  if (num_faces == 0) {
+    leaf_edge_offsets_.assign(1, 0);
+    leaf_edges_.clear();
+    boundary_edges_.clear();
+    leaf_states_.clear();
+    return;
+  }
+  // Spatial extents are measured relative to the whole mesh so they're comparable to normal
+  // extents (which span at most 2).
+  float diagonal = glm::length(max_bound - min_bound);
+  float spatial_scale = diagonal > 0 ? 2.0f / diagonal : 0.0f;
+  BuildNode(0, num_faces, centroids, normals, spatial_scale);
+
+  for (auto& node : nodes_) {
+    ComputeBounds(node, topology, positions, normals);
+  }
+  for (uint32_t leaf = 0; leaf < leaf_nodes_.size(); leaf++) {
+    const Node& node = nodes_[leaf_nodes_[leaf]];
+    for (uint32_t i = node.first_face; i < node.end_face; i++) {
+      face_leaf_[cluster_faces_[i]] = leaf;
+    }
+  }
+
+  // Bucket edges that stay inside one leaf by that leaf (counting sort), everything else with two
+  // faces becomes a boundary edge. Edges without exactly two faces can't be silhouettes.
+  size_t num_edges = topology.GetNumEdges();
+  size_t num_leaves = leaf_nodes_.size();
+  leaf_edge_offsets_.assign(num_leaves + 1, 0);
+  boundary_edges_.clear();
+  for (size_t e = 0; e < num_edges; e++) {
+    if (topology.GetEdgeFaceCount(e) != 2) {
+      continue;
+    }
+    uint32_t leaf0 = face_leaf_[topology.GetEdgeFace(e, 0)];
+    uint32_t leaf1 = face_leaf_[topology.GetEdgeFace(e, 1)];
+    if (leaf0 == leaf1) {
+      leaf_edge_offsets_[leaf0 + 1]++;
+    } else {
+      boundary_edges_.push_back(static_cast<uint32_t>(e));
+    }
+  }
+  for (size_t leaf = 0; leaf < num_leaves; leaf++) {
+    leaf_edge_offsets_[leaf + 1] += leaf_edge_offsets_[leaf];
+  }
+  leaf_edges_.resize(leaf_edge_offsets_[num_leaves]);
+  std::vector<uint32_t> cursor(leaf_edge_offsets_.begin(), leaf_edge_offsets_.end() - 1);
+  for (size_t e = 0; e < num_edges; e++) {
+    if (topology.GetEdgeFaceCount(e) != 2) {
+      continue;
+    }
+    uint32_t leaf0 = face_leaf_[topology.GetEdgeFace(e, 0)];
+    if (leaf0 == face_leaf_[topology.GetEdgeFace(e, 1)]) {
+      leaf_edges_[cursor[leaf0]++] = static_cast<uint32_t>(e);
+    }
+  }
+
+  leaf_states_.assign(num_leaves, MIXED_FACING);
+}
+
+uint32_t NormalConeHierarchy::BuildNode(uint32_t first_face, uint32_t end_face,
+                                        const std::vector<glm::vec3>& centroids,
+                                        const std::vector<glm::vec3>& normals,
+                                        float spatial_scale) {
+  uint32_t node_index = static_cast<uint32_t>(nodes_.size());
+  Node node;
+  node.first_face = first_face;
+  node.end_face = end_face;
+  node.first_leaf = static_cast<uint32_t>(leaf_nodes_.size());
+  node.left = -1;
+  node.right = -1;
+  nodes_.push_back(node);
+
+  if (end_face - first_face <= kMaxClusterFaces) {
+    leaf_nodes_.push_back(node_index);
+    nodes_[node_index].end_leaf = static_cast<uint32_t>(leaf_nodes_.size());
+    return node_index;
+  }
+
+  // Pick the widest of the 3 centroid axes and 3 normal axes, so clusters end up both spatially
+  // compact (for frustum culling) and with narrow normal cones (for facing tests).
+  glm::vec3 min_c(std::numeric_limits<float>::max()), max_c(-std::numeric_limits<float>::max());
+  glm::vec3 min_n(std::numeric_limits<float>::max()), max_n(-std::numeric_limits<float>::max());
+  for (uint32_t i = first_face; i < end_face; i++) {
+    uint32_t f = cluster_faces_[i];
+    min_c = glm::min(min_c, centroids[f]);
+    max_c = glm::max(max_c, centroids[f]);
+    if (normals[f] == normals[f]) {  // skip NaN normals of degenerate faces
+      min_n = glm::min(min_n, normals[f]);
+      max_n = glm::max(max_n, normals[f]);
+    }
+  }
+  glm::vec3 spatial_extent = (max_c - min_c) * spatial_scale;
+  glm::vec3 normal_extent = glm::max(max_n - min_n, glm::vec3(0.0f));
+  int best_axis = 0;
+  bool split_normals = false;
+  float best_extent = -1;
+  for (int axis = 0; axis < 3; axis++) {
+    if (spatial_extent[axis] > best_extent) {
+      best_extent = spatial_extent[axis];
+      best_axis = axis;
+      split_normals = false;
+    }
+    if (normal_extent[axis] > best_extent) {
+      best_extent = normal_extent[axis];
+      best_axis = axis;
+      split_normals = true;
+    }
+  }
+
+  // Median split
+  const std::vector<glm::vec3>& keys = split_normals ? normals : centroids;
+  uint32_t mid_face = first_face + (end_face - first_face) / 2;
+  std::nth_element(cluster_faces_.begin() + first_face, cluster_faces_.begin() + mid_face,
+                   cluster_faces_.begin() + end_face, [&](uint32_t a, uint32_t b) {
+                     // NaN keys compare as largest so the ordering stays strict weak
+                     float ka = keys[a][best_axis], kb = keys[b][best_axis];
+                     if (ka != ka) return false;
+                     if (kb != kb) return true;
+                     return ka < kb;
+                   });
+
+  int32_t left = static_cast<int32_t>(BuildNode(first_face, mid_face, centroids, normals,
+                                                spatial_scale));
+  int32_t right = static_cast<int32_t>(BuildNode(mid_face, end_face, centroids, normals,
+                                                 spatial_scale));
+  nodes_[node_index].left = left;
+  nodes_[node_index].right = right;
+  nodes_[node_index].end_leaf = static_cast<uint32_t>(leaf_nodes_.size());
+  return node_index;
+}
+
+void NormalConeHierarchy::ComputeBounds(Node& node, const EdgeTopology& topology,
+                                        const PositionArray& positions,
+                                        const std::vector<glm::vec3>& normals) const {
+  // Normal cone around the average normal
+  glm::vec3 normal_sum(0.0f);
+  bool has_invalid_normal = false;
+  for (uint32_t i = node.first_face; i < node.end_face; i++) {
+    const glm::vec3& n = normals[cluster_faces_[i]];
+    if (n != n) {
+      has_invalid_normal = true;
+      continue;
+    }
+    normal_sum += n;
+  }
+  float sum_length = glm::length(normal_sum);
+  node.cone_axis = sum_length > 1e-6f ? normal_sum / sum_length : glm::vec3(0.0f, 0.0f, 1.0f);
+  node.cone_cos = 1.0f;
+  for (uint32_t i = node.first_face; i < node.end_face; i++) {
+    const glm::vec3& n = normals[cluster_faces_[i]];
+    if (n == n) {
+      node.cone_cos = std::min(node.cone_cos, glm::dot(node.cone_axis, n));
+    }
+  }
+  // Degenerate faces have no meaningful facing, so clusters containing them are always tested
+  // face by face.
+  if (has_invalid_normal || sum_length <= 1e-6f) {
+    node.cone_cos = -1.0f;
+  }
+  node.cone_cos = glm::clamp(node.cone_cos, -1.0f, 1.0f);
+  node.cone_sin = std::sqrt(1.0f - node.cone_cos * node.cone_cos);
+
+  // Bounding sphere around the center of the vertex bounding box
+  glm::vec3 min_p(std::numeric_limits<float>::max()), max_p(-std::numeric_limits<float>::max());
+  for (uint32_t i = node.first_face; i < node.end_face; i++) {
+    for (int k = 0; k < 3; k++) {
+      const glm::vec3& p = positions[topology.GetFaceVertex(cluster_faces_[i], k)];
+      min_p = glm::min(min_p, p);
+      max_p = glm::max(max_p, p);
+    }
+  }
+  node.center = (min_p + max_p) * 0.5f;
+  float radius_sq = 0.0f;
+  for (uint32_t i = node.first_face; i < node.end_face; i++) {
+    for (int k = 0; k < 3; k++) {
+      glm::vec3 d = positions[topology.GetFaceVertex(cluster_faces_[i], k)] - node.center;
+      radius_sq = std::max(radius_sq, glm::dot(d, d));
+    }
+  }
+  node.radius = std::sqrt(radius_sq);
+}
+
+void NormalConeHierarchy::ClassifyClusters(const EdgeTopology& topology, const glm::vec3& view_dir,
+                                           const glm::mat4& object_to_clip,
+                                           std::vector<uint8_t>& face_facing) {
+  // Object space frustum planes (Gribb & Hartmann), normalized so sphere radii can be compared.
+  glm::vec4 planes[6];
+  for (int i = 0; i < 3; i++) {
+    glm::vec4 row(object_to_clip[0][i], object_to_clip[1][i], object_to_clip[2][i],
+                  object_to_clip[3][i]);
+    glm::vec4 w_row(object_to_clip[0][3], object_to_clip[1][3], object_to_clip[2][3],
+                    object_to_clip[3][3]);
+    planes[2 * i] = w_row + row;
+    planes[2 * i + 1] = w_row - row;
+  }
+  for (auto& plane : planes) {
+    float length = glm::length(glm::vec3(plane));
+    if (length > 0) {
+      plane /= length;
+    }
+  }
+  ClassifyClusters(topology, view_dir, planes, face_facing);
+}
+
+void NormalConeHierarchy::ClassifyClusters(const EdgeTopology& topology, const glm::vec3& view_dir,
+                                           std::vector<uint8_t>& face_facing) {
+  ClassifyClusters(topology, view_dir, nullptr, face_facing);
+}
+
+void NormalConeHierarchy::ClassifyClusters(const EdgeTopology& topology, const glm::vec3& view_dir,
+                                           const glm::vec4* frustum_planes,
+                                           std::vector<uint8_t>& face_facing) {
+  view_dir_ = view_dir;
+  face_facing.resize(topology.GetNumFaces());
+  if (nodes_.empty()) {
+    return;
+  }
+
+  const float* nx = topology.GetFaceNormalsX().data();
+  const float* ny = topology.GetFaceNormalsY().data();
+  const float* nz = topology.GetFaceNormalsZ().data();
+
+  node_stack_.assign(1, 0);
+  while (!node_stack_.empty()) {
+    const Node& node = nodes_[node_stack_.back()];
+    node_stack_.pop_back();
+
+    ClusterState state = MIXED_FACING;
+    for (int i = 0; frustum_planes != nullptr && i < 6; i++) {
+      const glm::vec4& plane = frustum_planes[i];
+      if (glm::dot(glm::vec3(plane), node.center) + plane.w < -node.radius) {
+        state = CULLED;
+        break;
+      }
+    }
+    if (state != CULLED && node.cone_cos > 0) {
+      // With a the angle between the cone axis and the view direction and t the half-angle, the
+      // cone is entirely front facing if a + t <= 90 degrees and back facing if a - t > 90.
+      float cos_a = glm::clamp(glm::dot(node.cone_axis, view_dir), -1.0f, 1.0f);
+      float sin_a = std::sqrt(1.0f - cos_a * cos_a);
+      if (cos_a * node.cone_cos - sin_a * node.cone_sin > kConeEpsilon) {
+        state = FRONT_FACING;
+      } else if (cos_a * node.cone_cos + sin_a * node.cone_sin < -kConeEpsilon) {
+        state = BACK_FACING;
+      }
+    }
+
+    if (state == MIXED_FACING && node.left >= 0) {
+      node_stack_.push_back(static_cast<uint32_t>(node.left));
+      node_stack_.push_back(static_cast<uint32_t>(node.right));
+      continue;
+    }
+    std::fill(leaf_states_.begin() + node.first_leaf, leaf_states_.begin() + node.end_leaf, state);
+    if (state == MIXED_FACING) {
+      // Exact per-face test only for the leaves that need it
+      for (uint32_t i = node.first_face; i < node.end_face; i++) {
+        uint32_t f = cluster_faces_[i];
+        face_facing[f] = nx[f] * view_dir.x + ny[f] * view_dir.y + nz[f] * view_dir.z >= 0;
+      }
+    }
+  }
+}
+
+bool NormalConeHierarchy::GetFaceFacing(uint32_t face, const EdgeTopology& topology,
+                                        const std::vector<uint8_t>& face_facing) const {
+  switch (leaf_states_[face_leaf_[face]]) {
+    case FRONT_FACING:
+      return true;
+    case BACK_FACING:
+      return false;
+    case MIXED_FACING:
+      return face_facing[face] != 0;
+    default:
+      // Culled clusters never had their faces tested
+      return glm::dot(topology.GetFaceNormal(face), view_dir_) >= 0;
+  }
+}
+
+void NormalConeHierarchy::FindSilhouetteEdges(const EdgeTopology& topology,
+                                              const std::vector<uint8_t>& face_facing,
+                                              std::vector<uint32_t>& silhouette_edges) const {
+  // Edges inside mixed leaves
+  for (size_t leaf = 0; leaf < leaf_states_.size(); leaf++) {
+    if (leaf_states_[leaf] != MIXED_FACING) {
+      continue;
+    }
+    for (uint32_t i = leaf_edge_offsets_[leaf]; i < leaf_edge_offsets_[leaf + 1]; i++) {
+      uint32_t e = leaf_edges_[i];
+      if (face_facing[topology.GetEdgeFace(e, 0)] != face_facing[topology.GetEdgeFace(e, 1)]) {
+        silhouette_edges.push_back(e);
+      }
+    }
+  }
+
+  // Edges between leaves, unless both sides are off-screen
+  for (uint32_t e : boundary_edges_) {
+    uint32_t f0 = topology.GetEdgeFace(e, 0);
+    uint32_t f1 = topology.GetEdgeFace(e, 1);
+    if (leaf_states_[face_leaf_[f0]] == CULLED && leaf_states_[face_leaf_[f1]] == CULLED) {
+      continue;
+    }
+    if (GetFaceFacing(f0, topology, face_facing) != GetFaceFacing(f1, topology, face_facing)) {
+      silhouette_edges.push_back(e);
+    }
+  }
+}
+}  // namespace GLOO
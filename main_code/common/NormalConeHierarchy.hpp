@@ -0,0 +1,91 @@
+#ifndef NORMAL_CONE_HIERARCHY_H_
+#define NORMAL_CONE_HIERARCHY_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "EdgeTopology.hpp"
+
+namespace GLOO {
+/**
+ * Binary hierarchy of face clusters used to skip silhouette tests on parts of a mesh that can't
+ * contain silhouettes.
+ *
+ * Every node bounds its faces with a normal cone (all face normals are within the cone's
+ * half-angle of its axis) and a bounding sphere. Given a view direction, a node whose cone lies
+ * entirely on one side of the view plane is uniformly front or back facing, so none of the edges
+ * inside it can be silhouettes. Nodes outside the view frustum are skipped as well. Only edges
+ * of the remaining ("mixed") leaf clusters, plus the edges that run between clusters, are tested.
+ */
+class NormalConeHierarchy {
+ public:
+  // Builds the hierarchy over the faces of `topology` (whose vertices are `positions`).
+  void Build(const EdgeTopology& topology, const PositionArray& positions);
+
+  /**
+   * Classifies every leaf cluster as front facing, back facing, mixed or culled, and computes the
+   * facing of the faces inside mixed clusters.
+   *
+   * @param view_dir Object space direction towards the viewer (orthographic approximation).
+   * @param object_to_clip Object to clip space matrix used for frustum culling.
+   * @param face_facing Per-face facing (1 = front). Only entries of faces in mixed clusters are
+   * written.
+   */
+  void ClassifyClusters(const EdgeTopology& topology, const glm::vec3& view_dir,
+                        const glm::mat4& object_to_clip, std::vector<uint8_t>& face_facing);
+  // Same as above without frustum culling, so silhouettes of the whole mesh are found.
+  void ClassifyClusters(const EdgeTopology& topology, const glm::vec3& view_dir,
+                        std::vector<uint8_t>& face_facing);
+
+  /**
+   * Appends the ids of silhouette edges to `silhouette_edges`, testing only the edges of mixed
+   * clusters and the edges between clusters. Must be called after ClassifyClusters.
+   */
+  void FindSilhouetteEdges(const EdgeTopology& topology, const std::vector<uint8_t>& face_facing,
+                           std::vector<uint32_t>& silhouette_edges) const;
+
+  size_t GetNumLeaves() const { return leaf_nodes_.size(); }
+
+ private:
+  enum ClusterState : uint8_t { FRONT_FACING, BACK_FACING, MIXED_FACING, CULLED };
+
+  struct Node {
+    glm::vec3 cone_axis;
+    float cone_cos;  // cosine of the half-angle (<= 0 means the cone can't be uniform)
+    float cone_sin;
+    glm::vec3 center;  // bounding sphere
+    float radius;
+    uint32_t first_face, end_face;  // range into cluster_faces_
+    uint32_t first_leaf, end_leaf;  // range of leaves below this node
+    int32_t left, right;            // child node indices, -1 for leaves
+  };
+
+  uint32_t BuildNode(uint32_t first_face, uint32_t end_face, const std::vector<glm::vec3>& centroids,
+                     const std::vector<glm::vec3>& normals, float spatial_scale);
+  void ComputeBounds(Node& node, const EdgeTopology& topology, const PositionArray& positions,
+                     const std::vector<glm::vec3>& normals) const;
+  void ClassifyClusters(const EdgeTopology& topology, const glm::vec3& view_dir,
+                        const glm::vec4* frustum_planes, std::vector<uint8_t>& face_facing);
+  bool GetFaceFacing(uint32_t face, const EdgeTopology& topology,
+                     const std::vector<uint8_t>& face_facing) const;
+
+  std::vector<Node> nodes_;
+  // Face ids grouped so every node's faces are contiguous
+  std::vector<uint32_t> cluster_faces_;
+  std::vector<uint32_t> face_leaf_;
+  std::vector<uint32_t> leaf_nodes_;
+  // CSR list of the edges whose two faces are both in the same leaf
+  std::vector<uint32_t> leaf_edge_offsets_;
+  std::vector<uint32_t> leaf_edges_;
+  // Edges whose two faces are in different leaves
+  std::vector<uint32_t> boundary_edges_;
+
+  // Per-frame state
+  std::vector<ClusterState> leaf_states_;
+  glm::vec3 view_dir_;
+  // Traversal stack of ClassifyClusters, kept to reuse its allocation
+  std::vector<uint32_t> node_stack_;
+};
+}  // namespace GLOO
+
+#endif
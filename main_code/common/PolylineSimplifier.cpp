@@ -0,0 +1,237 @@
+#include "PolylineSimplifier.hpp"
+
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POLYLINE_SIMPLIFIER_SSE2
+#endif
+
+namespace {
+// Squared distance from `p` to the segment [a, b].
+float SegmentDistanceSq(const glm::vec2& p, const glm::vec2& a, const glm::vec2& b) {
+  glm::vec2 ab = b - a;
+  glm::vec2 ap = p - a;
+  float length_sq = glm::dot(ab, ab);
+  float t = length_sq > 0 ? glm::clamp(glm::dot(ap, ab) / length_sq, 0.0f, 1.0f) : 0.0f;
+  glm::vec2 offset = ap - t * ab;
+  return glm::dot(offset, offset);
+}
+}  // namespace
+
+namespace GLOO {
+void PolylineSimplifier::Simplify(PolylineSet& polylines, const PositionArray& positions,
+                                  const glm::mat4& object_to_clip, const glm::vec2& window_size,
+                                  float tolerance_pixels) {
+  ProjectReferencedVertices(polylines, positions, object_to_clip, window_size);
+  float tolerance_sq = tolerance_pixels * tolerance_pixels;
+  // Kept points and polylines only ever move towards the front, so the set is compacted in place.
+  size_t num_polylines = polylines.GetNumPolylines();
+  size_t num_kept_polylines = 0;
+  uint32_t num_kept_indices = 0;
+  uint32_t path_start = polylines.offsets[0];
+  for (size_t i = 0; i < num_polylines; i++) {
+    uint32_t path_end = polylines.offsets[i + 1];
+    uint32_t* path = polylines.indices.data() + path_start;
+    size_t path_size = path_end - path_start;
+    bool is_loop = polylines.is_loop[i] != 0;
+    path_start = path_end;
+    if (!SimplifyPath(path, path_size, is_loop, tolerance_sq)) {
+      continue;
+    }
+    for (size_t j = 0; j < path_size; j++) {
+      if (keep_[j]) {
+        polylines.indices[num_kept_indices++] = path[j];
+      }
+    }
+    polylines.is_loop[num_kept_polylines] = is_loop;
+    polylines.offsets[++num_kept_polylines] = num_kept_indices;
+  }
+  polylines.indices.resize(num_kept_indices);
+  polylines.is_loop.resize(num_kept_polylines);
+  polylines.offsets.resize(num_kept_polylines + 1);
+}
+
+void PolylineSimplifier::ProjectReferencedVertices(const PolylineSet& polylines,
+                                                   const PositionArray& positions,
+                                                   const glm::mat4& object_to_clip,
+                                                   const glm::vec2& window_size) {
+  // Give each mesh vertex on a polyline a compact slot and gather its position.
+  if (vertex_stamps_.size() != positions.size()) {
+    vertex_stamps_.assign(positions.size(), 0);
+    vertex_slots_.resize(positions.size());
+    stamp_ = 0;
+  }
+  if (++stamp_ == 0) {
+    std::fill(vertex_stamps_.begin(), vertex_stamps_.end(), 0);
+    stamp_ = 1;
+  }
+  referenced_vertices_.clear();
+  xs_.clear();
+  ys_.clear();
+  zs_.clear();
+  for (uint32_t vertex : polylines.indices) {
+    if (vertex_stamps_[vertex] == stamp_) {
+      continue;
+    }
+    vertex_stamps_[vertex] = stamp_;
+    vertex_slots_[vertex] = static_cast<uint32_t>(referenced_vertices_.size());
+    referenced_vertices_.push_back(vertex);
+    xs_.push_back(positions[vertex].x);
+    ys_.push_back(positions[vertex].y);
+    zs_.push_back(positions[vertex].z);
+  }
+
+  // Screen coordinates are (clip.xy / clip.w + 1) / 2 * window_size, only x, y and w are needed.
+  size_t num_vertices = referenced_vertices_.size();
+  screen_x_.resize(num_vertices);
+  screen_y_.resize(num_vertices);
+  const glm::mat4& m = object_to_clip;  // column major, m[column][row]
+  glm::vec2 half_size = 0.5f * window_size;
+  size_t v = 0;
+#if defined(__AVX__)
+  // 8 vertices per iteration
+  __m256 m00 = _mm256_set1_ps(m[0][0]), m10 = _mm256_set1_ps(m[1][0]);
+  __m256 m20 = _mm256_set1_ps(m[2][0]), m30 = _mm256_set1_ps(m[3][0]);
+  __m256 m01 = _mm256_set1_ps(m[0][1]), m11 = _mm256_set1_ps(m[1][1]);
+  __m256 m21 = _mm256_set1_ps(m[2][1]), m31 = _mm256_set1_ps(m[3][1]);
+  __m256 m03 = _mm256_set1_ps(m[0][3]), m13 = _mm256_set1_ps(m[1][3]);
+  __m256 m23 = _mm256_set1_ps(m[2][3]), m33 = _mm256_set1_ps(m[3][3]);
+  __m256 half_x = _mm256_set1_ps(half_size.x), half_y = _mm256_set1_ps(half_size.y);
+  for (; v + 8 <= num_vertices; v += 8) {
+    __m256 x = _mm256_loadu_ps(xs_.data() + v);
+    __m256 y = _mm256_loadu_ps(ys_.data() + v);
+    __m256 z = _mm256_loadu_ps(zs_.data() + v);
+    __m256 cx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, x), _mm256_mul_ps(m10, y)),
+                              _mm256_add_ps(_mm256_mul_ps(m20, z), m30));
+    __m256 cy = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, x), _mm256_mul_ps(m11, y)),
+                              _mm256_add_ps(_mm256_mul_ps(m21, z), m31));
+    __m256 cw = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m03, x), _mm256_mul_ps(m13, y)),
+                              _mm256_add_ps(_mm256_mul_ps(m23, z), m33));
+    __m256 inv_w = _mm256_div_ps(_mm256_set1_ps(1.0f), cw);
+    _mm256_storeu_ps(screen_x_.data() + v,
+                     _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(cx, inv_w), _mm256_set1_ps(1.0f)),
+                                   half_x));
+    _mm256_storeu_ps(screen_y_.data() + v,
+                     _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(cy, inv_w), _mm256_set1_ps(1.0f)),
+                                   half_y));
+  }
+#elif defined(POLYLINE_SIMPLIFIER_SSE2)
+  // 4 vertices per iteration
+  __m128 m00 = _mm_set1_ps(m[0][0]), m10 = _mm_set1_ps(m[1][0]);
+  __m128 m20 = _mm_set1_ps(m[2][0]), m30 = _mm_set1_ps(m[3][0]);
+  __m128 m01 = _mm_set1_ps(m[0][1]), m11 = _mm_set1_ps(m[1][1]);
+  __m128 m21 = _mm_set1_ps(m[2][1]), m31 = _mm_set1_ps(m[3][1]);
+  __m128 m03 = _mm_set1_ps(m[0][3]), m13 = _mm_set1_ps(m[1][3]);
+  __m128 m23 = _mm_set1_ps(m[2][3]), m33 = _mm_set1_ps(m[3][3]);
+  __m128 half_x = _mm_set1_ps(half_size.x), half_y = _mm_set1_ps(half_size.y);
+  for (; v + 4 <= num_vertices; v += 4) {
+    __m128 x = _mm_loadu_ps(xs_.data() + v);
+    __m128 y = _mm_loadu_ps(ys_.data() + v);
+    __m128 z = _mm_loadu_ps(zs_.data() + v);
+    __m128 cx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)),
+                           _mm_add_ps(_mm_mul_ps(m20, z), m30));
+    __m128 cy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)),
+                           _mm_add_ps(_mm_mul_ps(m21, z), m31));
+    __m128 cw = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m03, x), _mm_mul_ps(m13, y)),
+                           _mm_add_ps(_mm_mul_ps(m23, z), m33));
+    __m128 inv_w = _mm_div_ps(_mm_set1_ps(1.0f), cw);
+    _mm_storeu_ps(screen_x_.data() + v,
+                  _mm_mul_ps(_mm_add_ps(_mm_mul_ps(cx, inv_w), _mm_set1_ps(1.0f)), half_x));
+    _mm_storeu_ps(screen_y_.data() + v,
+                  _mm_mul_ps(_mm_add_ps(_mm_mul_ps(cy, inv_w), _mm_set1_ps(1.0f)), half_y));
+  }
+#endif
+  // Scalar fallback (and remainder of the vectorized loops)
+  for (; v < num_vertices; v++) {
+    glm::vec4 clip = m * glm::vec4(xs_[v], ys_[v], zs_[v], 1.0f);
+    screen_x_[v] = (clip.x / clip.w + 1.0f) * half_size.x;
+    screen_y_[v] = (clip.y / clip.w + 1.0f) * half_size.y;
+  }
+}
+
+glm::vec2 PolylineSimplifier::GetScreenPoint(size_t path_index) const {
+  uint32_t slot = path_slots_[path_index % path_slots_.size()];
+  return glm::vec2(screen_x_[slot], screen_y_[slot]);
+}
+
+void PolylineSimplifier::MarkKeptPoints(size_t first, size_t last, float tolerance_sq) {
+  // Iterative Douglas-Peucker: keep the point furthest from each range's chord if it's outside
+  // the tolerance, and split the range there.
+  range_stack_.clear();
+  range_stack_.emplace_back(first, last);
+  while (!range_stack_.empty()) {
+    size_t a = range_stack_.back().first;
+    size_t b = range_stack_.back().second;
+    range_stack_.pop_back();
+    if (b <= a + 1) {
+      continue;
+    }
+    glm::vec2 pa = GetScreenPoint(a);
+    glm::vec2 pb = GetScreenPoint(b);
+    float max_distance_sq = -1.0f;
+    size_t furthest = a;
+    for (size_t i = a + 1; i < b; i++) {
+      float distance_sq = SegmentDistanceSq(GetScreenPoint(i), pa, pb);
+      if (distance_sq > max_distance_sq) {
+        max_distance_sq = distance_sq;
+        furthest = i;
+      }
+    }
+    if (max_distance_sq > tolerance_sq) {
+      keep_[furthest] = 1;
+      range_stack_.emplace_back(a, furthest);
+      range_stack_.emplace_back(furthest, b);
+    }
+  }
+}
+
+bool PolylineSimplifier::SimplifyPath(const uint32_t* path, size_t path_size, bool is_loop,
+                                      float tolerance_sq) {
+  // Disregard paths that have less than two vertices
+  if (path_size < 2) {
+    return false;
+  }
+  size_t n = path_size;
+  path_slots_.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    path_slots_[i] = vertex_slots_[path[i]];
+  }
+  keep_.assign(n, 0);
+  keep_[0] = 1;
+
+  if (is_loop) {
+    // Loops are split at the point furthest from the first one, and both halves are simplified
+    // (the second one ends back at the first point).
+    glm::vec2 start = GetScreenPoint(0);
+    size_t furthest = 0;
+    float max_distance_sq = -1.0f;
+    for (size_t i = 1; i < n; i++) {
+      glm::vec2 offset = GetScreenPoint(i) - start;
+      float distance_sq = glm::dot(offset, offset);
+      if (distance_sq > max_distance_sq) {
+        max_distance_sq = distance_sq;
+        furthest = i;
+      }
+    }
+    if (max_distance_sq < tolerance_sq) {
+      return false;
+    }
+    keep_[furthest] = 1;
+    MarkKeptPoints(0, furthest, tolerance_sq);
+    MarkKeptPoints(furthest, n, tolerance_sq);
+  } else {
+    glm::vec2 offset = GetScreenPoint(n - 1) - GetScreenPoint(0);
+    keep_[n - 1] = 1;
+    MarkKeptPoints(0, n - 1, tolerance_sq);
+    // Disregard paths that collapse to a single segment smaller than the tolerance
+    size_t num_kept = std::count(keep_.begin(), keep_.end(), 1);
+    if (num_kept == 2 && glm::dot(offset, offset) < tolerance_sq) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace GLOO
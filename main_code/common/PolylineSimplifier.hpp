@@ -0,0 +1,63 @@
+#ifndef POLYLINE_SIMPLIFIER_H_
+#define POLYLINE_SIMPLIFIER_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "main_code/npr_studio/PolylineNode.hpp"  // Includes polyline def.
+
+namespace GLOO {
+/**
+ * Screen space polyline simplification with Douglas-Peucker.
+ *
+ * Only the mesh vertices referenced by the polylines are projected (in SIMD batches), and each
+ * polyline keeps just enough of its points that no dropped point is further than the tolerance
+ * (in pixels) from the simplified line on screen, so corners that define its shape are never
+ * removed. Polylines are compacted in place, and scratch buffers are kept between calls, so
+ * simplifying every frame doesn't allocate.
+ */
+class PolylineSimplifier {
+ public:
+  /**
+   * Simplifies `polylines` in place. Polylines that are smaller than the tolerance on screen are
+   * removed.
+   *
+   * @param positions Object space positions of the mesh vertices the polylines index into.
+   * @param object_to_clip Projection * view * model matrix of the mesh.
+   * @param window_size Window size in pixels.
+   * @param tolerance_pixels Largest allowed screen distance between a dropped point and the
+   * simplified polyline.
+   */
+  void Simplify(PolylineSet& polylines, const PositionArray& positions,
+                const glm::mat4& object_to_clip, const glm::vec2& window_size,
+                float tolerance_pixels);
+
+ private:
+  void ProjectReferencedVertices(const PolylineSet& polylines,
+                                 const PositionArray& positions, const glm::mat4& object_to_clip,
+                                 const glm::vec2& window_size);
+  // Marks the kept points of the path in keep_, returning false if it collapses below the
+  // tolerance and should be removed.
+  bool SimplifyPath(const uint32_t* path, size_t path_size, bool is_loop, float tolerance_sq);
+  // Marks the points of path_slots_[first, last] that Douglas-Peucker keeps in keep_. Index
+  // path_slots_.size() wraps around to the first point (for loops).
+  void MarkKeptPoints(size_t first, size_t last, float tolerance_sq);
+  glm::vec2 GetScreenPoint(size_t path_index) const;
+
+  // Compact slot of each referenced mesh vertex; stamps avoid clearing it per call.
+  std::vector<uint32_t> vertex_stamps_;
+  std::vector<uint32_t> vertex_slots_;
+  uint32_t stamp_ = 0;
+  // Referenced vertices in slot order, their gathered positions and screen coordinates
+  std::vector<uint32_t> referenced_vertices_;
+  std::vector<float> xs_, ys_, zs_;
+  std::vector<float> screen_x_, screen_y_;
+  // Per polyline scratch
+  std::vector<uint32_t> path_slots_;
+  std::vector<uint8_t> keep_;
+  std::vector<std::pair<size_t, size_t>> range_stack_;
+};
+}  // namespace GLOO
+
+#endif
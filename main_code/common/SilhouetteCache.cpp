@@ -0,0 +1,135 @@
+#include "SilhouetteCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Rough per-cell bookkeeping cost (map node, list node, vector header) counted against the budget.
+const size_t kEntryOverhead = 64;
+}  // namespace
+
+namespace GLOO {
+SilhouetteCache::SilhouetteCache(int resolution) : resolution_(std::max(resolution, 1)) {}
+
+SilhouetteCache::~SilhouetteCache() {
+  Clear();
+}
+
+uint32_t SilhouetteCache::GetCell(const glm::vec3& view_dir) const {
+  // Octahedral mapping: project onto the octahedron |x| + |y| + |z| = 1, then fold the lower
+  // half over the diagonals so the whole sphere maps onto the square [-1, 1]^2.
+  float l1 = std::abs(view_dir.x) + std::abs(view_dir.y) + std::abs(view_dir.z);
+  if (!(l1 > 0)) {
+    return 0;
+  }
+  glm::vec3 p = view_dir / l1;
+  glm::vec2 uv(p.x, p.y);
+  if (p.z < 0) {
+    uv = glm::vec2((1.0f - std::abs(p.y)) * (p.x >= 0 ? 1.0f : -1.0f),
+                   (1.0f - std::abs(p.x)) * (p.y >= 0 ? 1.0f : -1.0f));
+  }
+  glm::ivec2 coords = glm::clamp(glm::ivec2((uv * 0.5f + 0.5f) * static_cast<float>(resolution_)),
+                                 glm::ivec2(0), glm::ivec2(resolution_ - 1));
+  return static_cast<uint32_t>(coords.y * resolution_ + coords.x);
+}
+
+glm::vec3 SilhouetteCache::GetCellDirection(uint32_t cell) const {
+  glm::vec2 uv((static_cast<float>(cell % resolution_) + 0.5f) / resolution_,
+               (static_cast<float>(cell / resolution_) + 0.5f) / resolution_);
+  uv = uv * 2.0f - 1.0f;
+  // Inverse of the octahedral mapping in GetCell
+  glm::vec3 p(uv.x, uv.y, 1.0f - std::abs(uv.x) - std::abs(uv.y));
+  if (p.z < 0) {
+    p = glm::vec3((1.0f - std::abs(uv.y)) * (uv.x >= 0 ? 1.0f : -1.0f),
+                  (1.0f - std::abs(uv.x)) * (uv.y >= 0 ? 1.0f : -1.0f), p.z);
+  }
+  return glm::normalize(p);
+}
+
+bool SilhouetteCache::Lookup(uint32_t cell, std::vector<uint32_t>& edges) {
+  auto it = entries_.find(cell);
+  if (it == entries_.end()) {
+    return false;
+  }
+  LruList& lru = GetShared().lru;
+  lru.splice(lru.begin(), lru, it->second.lru_position);
+
+  // Each byte holds 7 bits of a delta, the high bit marks that more bytes follow.
+  edges.clear();
+  uint32_t previous = 0;
+  uint32_t delta = 0;
+  int shift = 0;
+  for (uint8_t byte : it->second.data) {
+    delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if (byte & 0x80) {
+      shift += 7;
+      continue;
+    }
+    previous += delta;
+    edges.push_back(previous);
+    delta = 0;
+    shift = 0;
+  }
+  return true;
+}
+
+void SilhouetteCache::Insert(uint32_t cell, const std::vector<uint32_t>& edges) {
+  auto it = entries_.find(cell);
+  if (it != entries_.end()) {
+    Erase(it);
+  }
+
+  // Sorted ids of nearby edges have small gaps, so most deltas fit in one or two bytes.
+  scratch_.assign(edges.begin(), edges.end());
+  std::sort(scratch_.begin(), scratch_.end());
+  Entry entry;
+  entry.data.reserve(scratch_.size() * 2);
+  uint32_t previous = 0;
+  for (uint32_t edge : scratch_) {
+    uint32_t delta = edge - previous;
+    previous = edge;
+    while (delta >= 0x80) {
+      entry.data.push_back(static_cast<uint8_t>(delta | 0x80));
+      delta >>= 7;
+    }
+    entry.data.push_back(static_cast<uint8_t>(delta));
+  }
+  entry.data.shrink_to_fit();
+
+  Shared& shared = GetShared();
+  memory_usage_ += entry.data.size() + kEntryOverhead;
+  shared.usage += entry.data.size() + kEntryOverhead;
+  shared.lru.emplace_front(this, cell);
+  entry.lru_position = shared.lru.begin();
+  entries_[cell] = std::move(entry);
+  EvictToBudget();
+}
+
+void SilhouetteCache::Clear() {
+  while (!entries_.empty()) {
+    Erase(entries_.begin());
+  }
+}
+
+void SilhouetteCache::SetMemoryBudget(size_t bytes) {
+  GetShared().budget = bytes;
+  EvictToBudget();
+}
+
+void SilhouetteCache::Erase(std::unordered_map<uint32_t, Entry>::iterator it) {
+  size_t bytes = it->second.data.size() + kEntryOverhead;
+  memory_usage_ -= bytes;
+  GetShared().usage -= bytes;
+  GetShared().lru.erase(it->second.lru_position);
+  entries_.erase(it);
+}
+
+void SilhouetteCache::EvictToBudget() {
+  // Always keep the most recently used cell, even if it alone is over budget
+  Shared& shared = GetShared();
+  while (shared.usage > shared.budget && shared.lru.size() > 1) {
+    SilhouetteCache* cache = shared.lru.back().first;
+    cache->Erase(cache->entries_.find(shared.lru.back().second));
+  }
+}
+}  // namespace GLOO
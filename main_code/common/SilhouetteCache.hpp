@@ -0,0 +1,78 @@
+#ifndef SILHOUETTE_CACHE_H_
+#define SILHOUETTE_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gloo/alias_types.hpp"
+
+namespace GLOO {
+/**
+ * Cache of silhouette edge sets keyed by (quantized) view direction.
+ *
+ * Silhouettes are computed for a single object space view direction (see
+ * OutlineNode::GetLocalCameraDirection), so the set only depends on where that direction falls on
+ * the unit sphere. The sphere is split into resolution x resolution cells using an octahedral
+ * mapping, and each cell stores the silhouette for the direction at its center. Edge sets are
+ * stored sorted and delta + varint encoded.
+ *
+ * All caches (one per OutlineNode) share a single memory budget, so a model split into many
+ * groups doesn't multiply it. Once the stored bytes of all caches exceed it, the least recently
+ * used cells across all caches are evicted.
+ */
+class SilhouetteCache {
+ public:
+  explicit SilhouetteCache(int resolution = 128);
+  ~SilhouetteCache();
+  SilhouetteCache(const SilhouetteCache&) = delete;
+  void operator=(const SilhouetteCache&) = delete;
+
+  // Returns the cell containing the (not necessarily normalized) direction `view_dir`.
+  uint32_t GetCell(const glm::vec3& view_dir) const;
+  // Returns the unit direction at the center of `cell`, which cached silhouettes are computed for.
+  glm::vec3 GetCellDirection(uint32_t cell) const;
+
+  // Decodes the silhouette of `cell` into `edges` and returns true if it is cached.
+  bool Lookup(uint32_t cell, std::vector<uint32_t>& edges);
+  // Stores the silhouette edge ids `edges` for `cell`, evicting old cells (of any cache) if over
+  // the shared budget.
+  void Insert(uint32_t cell, const std::vector<uint32_t>& edges);
+  void Clear();
+
+  // Memory budget shared by all caches.
+  static void SetMemoryBudget(size_t bytes);
+  static size_t GetMemoryBudget() { return GetShared().budget; }
+  static size_t GetTotalMemoryUsage() { return GetShared().usage; }
+  size_t GetMemoryUsage() const { return memory_usage_; }
+  size_t GetNumCells() const { return entries_.size(); }
+
+ private:
+  typedef std::list<std::pair<SilhouetteCache*, uint32_t>> LruList;
+  struct Entry {
+    std::vector<uint8_t> data;
+    LruList::iterator lru_position;
+  };
+  // State shared by all caches
+  struct Shared {
+    size_t budget = 32 << 20;
+    size_t usage = 0;
+    LruList lru;  // most recently used (cache, cell) first
+  };
+  static Shared& GetShared() {
+    static Shared shared;
+    return shared;
+  }
+  static void EvictToBudget();
+  void Erase(std::unordered_map<uint32_t, Entry>::iterator it);
+
+  int resolution_;
+  size_t memory_usage_ = 0;
+  std::unordered_map<uint32_t, Entry> entries_;
+  std::vector<uint32_t> scratch_;
+};
+}  // namespace GLOO
+
+#endif
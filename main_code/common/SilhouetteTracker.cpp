@@ -0,0 +1,121 @@
+#include "SilhouetteTracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Number of updates over which the probe sweeps every edge once.
+const size_t kProbeFrames = 32;
+}  // namespace
+
+namespace GLOO {
+void SilhouetteTracker::Reset(const EdgeTopology& topology, const glm::vec3& view_dir,
+                              const std::vector<uint32_t>& silhouette_edges) {
+  silhouette_edges_ = silhouette_edges;
+  view_dir_ = view_dir;
+  seeded_ = true;
+  face_stamps_.assign(topology.GetNumFaces(), 0);
+  edge_stamps_.assign(topology.GetNumEdges(), 0);
+  stamp_ = 0;
+  probe_cursor_ = 0;
+}
+
+void SilhouetteTracker::SetMaxStepAngle(float radians) { cos_max_step_angle_ = std::cos(radians); }
+
+bool SilhouetteTracker::IsFrontFacing(const EdgeTopology& topology, uint32_t face,
+                                      const glm::vec3& view_dir) const {
+  return glm::dot(topology.GetFaceNormal(face), view_dir) >= 0;
+}
+
+void SilhouetteTracker::VisitFace(uint32_t face) {
+  if (face_stamps_[face] != stamp_) {
+    face_stamps_[face] = stamp_;
+    face_stack_.push_back(face);
+    visited_faces_.push_back(face);
+  }
+}
+
+bool SilhouetteTracker::Update(const EdgeTopology& topology, const glm::vec3& view_dir,
+                               std::vector<uint32_t>& silhouette_edges) {
+  if (!seeded_ || face_stamps_.size() != topology.GetNumFaces()) {
+    return false;
+  }
+  // Fall back to a full sweep if the view jumped
+  float view_length = glm::length(view_dir) * glm::length(view_dir_);
+  if (!(view_length > 0) || glm::dot(view_dir, view_dir_) < cos_max_step_angle_ * view_length) {
+    return false;
+  }
+
+  if (++stamp_ == 0) {
+    std::fill(face_stamps_.begin(), face_stamps_.end(), 0);
+    std::fill(edge_stamps_.begin(), edge_stamps_.end(), 0);
+    stamp_ = 1;
+  }
+
+  // Seed the walk with the faces on both sides of the previous silhouette
+  face_stack_.clear();
+  visited_faces_.clear();
+  for (uint32_t e : silhouette_edges_) {
+    VisitFace(topology.GetEdgeFace(e, 0));
+    VisitFace(topology.GetEdgeFace(e, 1));
+  }
+  // Probe a rotating slice of the edges for silhouettes born away from the existing ones, so new
+  // loops get picked up (and tracked from then on) within kProbeFrames updates.
+  size_t num_edges = topology.GetNumEdges();
+  size_t probe_count = (num_edges + kProbeFrames - 1) / kProbeFrames;
+  for (size_t i = 0; i < probe_count && num_edges > 0; i++) {
+    uint32_t e = static_cast<uint32_t>(probe_cursor_);
+    probe_cursor_ = probe_cursor_ + 1 == num_edges ? 0 : probe_cursor_ + 1;
+    if (topology.GetEdgeFaceCount(e) == 2) {
+      uint32_t f0 = topology.GetEdgeFace(e, 0);
+      uint32_t f1 = topology.GetEdgeFace(e, 1);
+      if (IsFrontFacing(topology, f0, view_dir) != IsFrontFacing(topology, f1, view_dir)) {
+        VisitFace(f0);
+        VisitFace(f1);
+      }
+    }
+  }
+
+  // Spread through every face whose facing could have flipped: |n.v_new - n.v_old| is at most
+  // |v_new - v_old|, so only faces at most that far from edge-on qualify. Walking just the faces
+  // that did flip would stop at unflipped faces between two flipped ones (common on triangulated
+  // quads).
+  glm::vec3 new_dir = glm::normalize(view_dir);
+  float max_flip_dot = glm::length(new_dir - glm::normalize(view_dir_));
+  while (!face_stack_.empty()) {
+    uint32_t face = face_stack_.back();
+    face_stack_.pop_back();
+    if (std::abs(glm::dot(topology.GetFaceNormal(face), new_dir)) > max_flip_dot) {
+      continue;
+    }
+    for (int i = 0; i < 3; i++) {
+      uint32_t e = topology.GetFaceEdge(face, i);
+      if (topology.GetEdgeFaceCount(e) != 2) {
+        continue;
+      }
+      uint32_t f0 = topology.GetEdgeFace(e, 0);
+      VisitFace(f0 == face ? topology.GetEdgeFace(e, 1) : f0);
+    }
+  }
+
+  // The new silhouette can only lie on edges of the faces we reached
+  silhouette_edges_.clear();
+  for (uint32_t face : visited_faces_) {
+    for (int i = 0; i < 3; i++) {
+      uint32_t e = topology.GetFaceEdge(face, i);
+      if (edge_stamps_[e] == stamp_) {
+        continue;
+      }
+      edge_stamps_[e] = stamp_;
+      if (topology.GetEdgeFaceCount(e) == 2 &&
+          IsFrontFacing(topology, topology.GetEdgeFace(e, 0), view_dir) !=
+              IsFrontFacing(topology, topology.GetEdgeFace(e, 1), view_dir)) {
+        silhouette_edges_.push_back(e);
+      }
+    }
+  }
+  view_dir_ = view_dir;
+  silhouette_edges = silhouette_edges_;
+  return true;
+}
+}  // namespace GLOO
@@ -0,0 +1,68 @@
+#ifndef SILHOUETTE_TRACKER_H_
+#define SILHOUETTE_TRACKER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "EdgeTopology.hpp"
+
+namespace GLOO {
+/**
+ * Incrementally follows silhouette edges between frames while the view changes slowly.
+ *
+ * Between two nearby view directions, the faces whose facing flips form bands next to the old
+ * silhouette. Instead of testing every edge again, the tracker starts at the faces of the previous
+ * silhouette edges and walks the face adjacency outwards through faces that flipped, then only
+ * tests the edges of the faces it reached. Work is proportional to the size of the silhouette and
+ * of the swept band rather than the mesh.
+ *
+ * Silhouette loops that appear away from any existing silhouette (e.g. a bump turning into view)
+ * aren't reached by the walk. A small rotating slice of the edges is probed every update to pick
+ * them up within a few frames, but callers should still do a full sweep whenever the tracker
+ * reports a jump and once the view comes to rest.
+ */
+class SilhouetteTracker {
+ public:
+  /**
+   * Seeds the tracker with the result of a full silhouette sweep.
+   *
+   * @param view_dir Object space view direction the silhouettes were computed for.
+   * @param silhouette_edges Ids of all silhouette edges for that view.
+   */
+  void Reset(const EdgeTopology& topology, const glm::vec3& view_dir,
+             const std::vector<uint32_t>& silhouette_edges);
+
+  /**
+   * Advances the silhouette to `view_dir`. Returns false (leaving `silhouette_edges` untouched)
+   * if the tracker hasn't been seeded or the view turned by more than the maximum step angle since
+   * the last update, in which case a full sweep followed by Reset() is needed.
+   */
+  bool Update(const EdgeTopology& topology, const glm::vec3& view_dir,
+              std::vector<uint32_t>& silhouette_edges);
+
+  // Largest view change (in radians) per update that is still tracked incrementally.
+  void SetMaxStepAngle(float radians);
+  // Forgets the seed, so the next Update() asks for a full sweep.
+  void Clear() { seeded_ = false; }
+  bool IsSeeded() const { return seeded_; }
+
+ private:
+  bool IsFrontFacing(const EdgeTopology& topology, uint32_t face, const glm::vec3& view_dir) const;
+  void VisitFace(uint32_t face);
+
+  std::vector<uint32_t> silhouette_edges_;
+  glm::vec3 view_dir_;
+  bool seeded_ = false;
+  float cos_max_step_angle_ = 0.9961947f;  // cos(5 degrees)
+
+  // Scratch state of the walk. Stamps avoid clearing per-face/per-edge marks every update.
+  std::vector<uint32_t> face_stamps_;
+  std::vector<uint32_t> edge_stamps_;
+  uint32_t stamp_ = 0;
+  size_t probe_cursor_ = 0;
+  std::vector<uint32_t> face_stack_;
+  std::vector<uint32_t> visited_faces_;
+};
+}  // namespace GLOO
+
+#endif
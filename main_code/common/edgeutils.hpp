@@ -2,284 +2,163 @@
 #define EDGEUTILS_H_
 #include <algorithm>
 #include <iostream>
-#include <unordered_map>
-#include <unordered_set>
+#include <limits>
 #include <vector>
 
-#include "../../gloo/shaders/MiterOutlineShader.hpp"
 #include "../npr_studio/OutlineNode.hpp"  // Includes polyline def.
+#include "EdgeChainScratch.hpp"
 
 namespace GLOO {
 
 // We only consider loops if they're more than 2 nodes long (3-length cycles and up)
 const int edge_cycle_length = 3;
 
-// Function to perform depth-first search to find the longest chain
-void dfs(size_t node, const std::unordered_map<size_t, std::unordered_set<size_t>>& adjList,
-         std::unordered_set<size_t>& visited, std::vector<size_t>& currentPath,
-         std::vector<size_t>& connectedComponent, std::vector<Polyline>& paths) {
-  visited.insert(node);
-  connectedComponent.push_back(node);
-  currentPath.push_back(node);
-
-  int counter = 0;
-  for (size_t neighbor : adjList.at(node)) {
-    // TODO: if we have multiple neighbors, find a way to combine the paths produced by all of
-    // them together somehow
-    if (visited.find(neighbor) == visited.end()) {
-      dfs(neighbor, adjList, visited, currentPath, connectedComponent, paths);
-      counter++;
-    }
+// Builds the CSR adjacency of `edges` with a counting sort over (densely renumbered) vertices.
+void buildEdgeAdjacency(const std::vector<Edge>& edges, EdgeChainScratch& scratch) {
+  auto& adjacency = scratch.adjacency;
+  auto& vertices = adjacency.vertices;
+  vertices.clear();
+  for (const Edge& edge : edges) {
+    vertices.push_back(static_cast<uint32_t>(edge.first));
+    vertices.push_back(static_cast<uint32_t>(edge.second));
   }
-
-  // Emit path if we're at a leaf
-  // TODO: add some way to prune the path to prevent too much work?
-  if (counter == 0) {
-    if (currentPath.size() > 0) {
-      Polyline line;
-      auto firstElt = currentPath.front();
-      auto lastElt = currentPath.back();
-      // We only consider loops if they're more than 2 nodes long (3-length cycles and up)
-      line.is_loop =
-          adjList.at(firstElt).count(lastElt) > 0 && currentPath.size() >= edge_cycle_length;
-      line.path = currentPath;
-      paths.push_back(line);
-    }
+  std::sort(vertices.begin(), vertices.end());
+  vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+  auto& endpoints = scratch.endpoints;
+  endpoints.resize(2 * edges.size());
+  for (size_t i = 0; i < edges.size(); i++) {
+    endpoints[2 * i] = static_cast<uint32_t>(
+        std::lower_bound(vertices.begin(), vertices.end(), edges[i].first) - vertices.begin());
+    endpoints[2 * i + 1] = static_cast<uint32_t>(
+        std::lower_bound(vertices.begin(), vertices.end(), edges[i].second) - vertices.begin());
   }
 
-  // Backtrack
-  currentPath.pop_back();
-}
-
-/**
- * Splits polylines in `paths` into new ones, ensuring that no polylines over max_size are left in
- * the resulting `paths` array.
- * TODO: add 3-lengh segment between long polyline breaks to approximate "joins"?
- *
- * @param paths: The vector of polylines to be split.
- * @param max_size: The maximum size of a polyline. Must be > 1.
- *
- * Function testing: test with max_size > pathSize, max_size < pathSize, max_size = pathSize
- * For cylinder:  max_size = 4, 2, 32;
- */
-void splitPolylines(std::vector<Polyline>& paths, int max_size) {
-  // Enforce precondition
-  if (max_size <= 1) {
-    throw std::runtime_error("max_size must be > 1");
+  // Count degrees, prefix sum, then scatter (edges stay in input order within each vertex)
+  auto& offsets = adjacency.offsets;
+  offsets.assign(vertices.size() + 1, 0);
+  for (uint32_t v : endpoints) {
+    offsets[v + 1]++;
   }
-  std::vector<Polyline> new_polylines;
-  // Split existing polylines
-  for (auto& polyline : paths) {
-    int num_splits = polyline.path.size() / max_size;
-    // If the polyline needed to have more than one split, then it's not a loop by definition.
-    // If no splits were necessary, just use the existing loop value.
-    bool areSplitsLoops = num_splits > 0 ? false : polyline.is_loop;
-
-    // Iterate through polyline to split it, only stopping when we've reached the end of the array
-    long currentIndex = 0;
-    while ((currentIndex + max_size) <= polyline.path.size()) {
-      // Create a new polyline with vertices "max_size" starting at currentIndex.
-      Polyline new_polyline;
-      long beginning_index = currentIndex;
-      long end_index = beginning_index + max_size;
-      new_polyline.path = std::vector<size_t>(polyline.path.begin() + beginning_index,
-                                              polyline.path.begin() + end_index);
-      new_polyline.is_loop = areSplitsLoops;
-      new_polylines.push_back(new_polyline);
-      // Start the polyline one node "back" if we're going after the first split, just so we can
-      // capture the connection to the starting node.
-      currentIndex += (max_size - 1);
-    }
-    long remainingIndices = (polyline.path.size() - 1) - currentIndex;
-
-    // Add ending polyline segment original polyline based on splits we did
-    // Don't include polyline if its size would be 0 and the polyline isn't a loop.
-    if (remainingIndices > 0) {
-      Polyline end_segment;
-      end_segment.is_loop = areSplitsLoops;
-      end_segment.path =
-          std::vector<size_t>(polyline.path.begin() + currentIndex, polyline.path.end());
-
-      // If the polyline was a loop and we split it, add additional vertex that connects the
-      // original polyline head with its tail
-      auto lineHead = polyline.path.front();
-      if (polyline.is_loop && num_splits > 0) {
-        end_segment.path.push_back(lineHead);
-      }
-      new_polylines.push_back(end_segment);
-    } else if (remainingIndices == 0 && polyline.is_loop) {
-      // We've split the polylines exactly, so push a single line that connects the head to
-      // the tail.
-      Polyline end_segment;
-      end_segment.path = {polyline.path.front(), polyline.path.back()};
-      end_segment.is_loop = areSplitsLoops;  // line segment
-      new_polylines.push_back(end_segment);
-    }
+  for (size_t v = 0; v < vertices.size(); v++) {
+    offsets[v + 1] += offsets[v];
+  }
+  adjacency.neighbors.resize(endpoints.size());
+  adjacency.edge_ids.resize(endpoints.size());
+  auto& cursor = scratch.cursor;
+  cursor.assign(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < edges.size(); i++) {
+    uint32_t a = endpoints[2 * i];
+    uint32_t b = endpoints[2 * i + 1];
+    adjacency.neighbors[cursor[a]] = b;
+    adjacency.edge_ids[cursor[a]++] = static_cast<uint32_t>(i);
+    adjacency.neighbors[cursor[b]] = a;
+    adjacency.edge_ids[cursor[b]++] = static_cast<uint32_t>(i);
   }
-
-  // Replace our original paths with our new polylines
-  paths = new_polylines;
 }
 
 /**
- * Simplifies polylines based on the minimum distance (in pixels) between their points.
+ * Walks a chain of unused edges starting at local vertex `start` and appends it to `paths`.
+ * At every vertex the walk continues along the unused edge that bends the least (ties go to the
+ * first edge in adjacency order), so chains pass straight through junctions and the result
+ * doesn't depend on hash ordering.
  */
-void simplifyPolylines(std::vector<Polyline>& polylines, const PositionArray& meshPositions,
-                       const float& minPixelDistance, const CameraComponent* camera,
-                       const glm::vec2 window_size, const glm::mat4& model_matrix) {
-  glm::mat4 worldToNDC(camera->GetProjectionMatrix() * camera->GetViewMatrix());
-  std::vector<glm::vec2> modelScreenspacePositions;
-
-  // Transform model coordinates to screenspace coordinates to compare pixel distances
-  for (glm::vec3 objectPosition : meshPositions) {
-    // Convert to world coordinates, then NDC coordinates, then do perspective division, then go to
-    // screenspace coordinates
-    glm::vec3 world_position = glm::vec3(model_matrix * glm::vec4(objectPosition, 1.0));
-    glm::vec4 ndc_position = worldToNDC * glm::vec4(world_position, 1.0);
-    glm::vec3 perspective_position = glm::vec3(ndc_position) / ndc_position.w;
-    glm::vec2 screenspace_coordinates =
-        (glm::vec2(perspective_position) + 1.0f) * 0.5f * window_size;
-    modelScreenspacePositions.push_back(screenspace_coordinates);
-  }
-
-  std::vector<Polyline> newPolylines;
-  // Iterate through contents of each path, and only emit vertices that have a pixel distance that's
-  // greater our threshold
-  for (auto& polyline : polylines) {
-    // Disregard paths that have less than two vertices
-    if (polyline.path.size() < 2) {
-      continue;
-    }
-
-    std::vector<size_t> newPath;
-    size_t current_path_start =
-        polyline.path[0];  // the polyline index we're currently comparing to
-    newPath.push_back(current_path_start);
-    // Go until the next to last vertex
-    for (int i = 1; i < polyline.path.size() - 1; i++) {
-      auto vertex = polyline.path[i];
-      // If we now have a segment that's greater than the pixel distance, add it, and start
-      // processing from the end of the path
-      if (glm::abs(glm::distance(modelScreenspacePositions[vertex],
-                                 modelScreenspacePositions[current_path_start]) >=
-                   minPixelDistance)) {
-        newPath.push_back(vertex);
-        current_path_start = vertex;
-      }
-    }
-    // Always add the last vertex
-    newPath.push_back(polyline.path.back());
-
-    // Disregard new paths that have two vertices but are smaller than our pixel distance
-    if (newPath.size() == 2) {
-      if (glm::abs(glm::distance(modelScreenspacePositions[newPath.front()],
-                                 modelScreenspacePositions[newPath.back()]) < minPixelDistance)) {
+void chainEdges(uint32_t start, const EdgeAdjacency& adjacency, const PositionArray& positions,
+                std::vector<uint8_t>& used, PolylineSet& paths) {
+  size_t pathStart = paths.indices.size();
+  paths.indices.push_back(adjacency.vertices[start]);
+  uint32_t previous = start;
+  uint32_t current = start;
+  while (true) {
+    uint32_t end = adjacency.offsets[current + 1];
+    uint32_t best = end;
+    float best_alignment = -std::numeric_limits<float>::infinity();
+    glm::vec3 incoming =
+        positions[adjacency.vertices[current]] - positions[adjacency.vertices[previous]];
+    for (uint32_t i = adjacency.offsets[current]; i < end; i++) {
+      if (used[adjacency.edge_ids[i]]) {
         continue;
       }
+      if (current == previous) {
+        // No incoming direction at the start of the chain, take the first edge.
+        best = i;
+        break;
+      }
+      glm::vec3 outgoing = positions[adjacency.vertices[adjacency.neighbors[i]]] -
+                           positions[adjacency.vertices[current]];
+      float lengths = glm::length(incoming) * glm::length(outgoing);
+      float alignment = lengths > 0 ? glm::dot(incoming, outgoing) / lengths : -1.0f;
+      if (alignment > best_alignment) {
+        best_alignment = alignment;
+        best = i;
+      }
     }
-
-    // Create new simplified polyline
-    Polyline newPolyline;
-    newPolyline.path = newPath;
-    // If the polyline was a loop, it stays a loop
-    newPolyline.is_loop = polyline.is_loop;
-    newPolylines.push_back(newPolyline);
-    int simplifiedVerts = polyline.path.size() - newPath.size();
-    if (simplifiedVerts > 5) {
-      std::cout << "Removed " << simplifiedVerts << "verts" << std::endl;
+    if (best == end) {
+      break;  // no unused edges left here
     }
+    used[adjacency.edge_ids[best]] = 1;
+    previous = current;
+    current = adjacency.neighbors[best];
+    paths.indices.push_back(adjacency.vertices[current]);
   }
-  polylines = newPolylines;
-}
-
-// Performs dfs on `node` using give adjList, but visits every edge instead of just visiting every
-// node.
-void edgeDfs(size_t node, const std::unordered_map<size_t, std::unordered_set<size_t>>& adjList,
-             std::unordered_set<Edge, pairhash, KeyEqual>& visited,
-             std::unordered_set<size_t>& finished, std::vector<size_t>& currentPath,
-             std::vector<Polyline>& paths) {
-  currentPath.push_back(node);
-
-  // Go through each node's connection
-  int counter = 0;
-  for (size_t neighbor : adjList.at(node)) {
-    Edge connection = Edge(node, neighbor);
 
-    // TODO: if we have multiple neighbors, find a way to combine the paths produced by all of
-    // them together somehow
-    if (visited.find(connection) == visited.end()) {
-      // Mark connection as visited
-      visited.insert(connection);
-      edgeDfs(neighbor, adjList, visited, finished, currentPath, paths);
-      counter++;
-    }
-  }
-  // Once we're done exploring the node's connections, mark it as finished
-  finished.insert(node);
-
-  // Emit path if we're at a leaf
-  // TODO: add some way to prune the path to prevent too much work?
-  if (counter == 0) {
-    if (currentPath.size() > 0) {
-      Polyline line;
-      auto firstElt = currentPath.front();
-      auto lastElt = currentPath.back();
-      // We only consider loops if they're more than 2 nodes long (3-length cycles and up)
-      line.is_loop = firstElt == lastElt && currentPath.size() >= edge_cycle_length;
-      line.path = currentPath;
-      // Remove the last element from the polyline if the line is a loop since it's the same as
-      // the first (allows for easier logic later)
-      if (line.is_loop) {
-        line.path.pop_back();
-      }
-      paths.push_back(line);
-    }
+  // We only consider loops if they're more than 2 nodes long (3-length cycles and up)
+  bool isLoop = current == start && paths.indices.size() - pathStart >= edge_cycle_length;
+  // Remove the last element from the polyline if the line is a loop since it's the same as the
+  // first (allows for easier logic later)
+  if (isLoop) {
+    paths.indices.pop_back();
   }
-
-  // Backtrack
-  currentPath.pop_back();
+  paths.EndPolyline(isLoop);
 }
 
 /**
- * Function to transform edges to polylines. A polyline is a consecutive list of vertices that
- * traverse a "chain" of connected vertices in a graph. Every vertex is guaranteed to be
- * represented at aleast once in the list of polylines. Unfortunately, there's no guarantee that
- * the polylines are efficient, i.e. that the longest polyline represents the longest possible
- * chain length of the graph (since that is an NP-hard problem).
+ * Function to transform edges to polylines, which are appended to `paths`. A polyline is a
+ * consecutive list of vertices that traverse a "chain" of connected vertices in a graph. Every
+ * edge is guaranteed to be represented exactly once in the list of polylines. Finding the fewest
+ * polylines is NP-hard, so chains are grown greedily: they start at chain ends (degree 1), then at
+ * junctions, then whatever is left (closed loops), always continuing along the straightest unused
+ * edge. The walk is iterative, so arbitrarily long chains don't grow the stack.
+ *
+ * @param positions Mesh positions the edge indices refer to, used to pick straight continuations.
+ * @param scratch Working memory, reused between calls.
  */
-std::vector<Polyline> edgesToPolylines(const std::vector<Edge>& edges) {
-  // Build an adjacency list from the edges
-  std::unordered_map<size_t, std::unordered_set<size_t>> adjList;
-  for (const Edge& edge : edges) {
-    adjList[edge.first].insert(edge.second);
-    adjList[edge.second].insert(edge.first);
-  }
-
-  std::vector<Polyline> paths;
-  // Perform edge-DFS to find the longest path for each connected component
-  // Use edge-dfs to ensure all connections between nodes get rendered, not just each node.
-  std::unordered_set<size_t> finished;
-  std::unordered_set<Edge, pairhash, KeyEqual> visited;
+void edgesToPolylines(const std::vector<Edge>& edges, const PositionArray& positions,
+                      EdgeChainScratch& scratch, PolylineSet& paths) {
+  buildEdgeAdjacency(edges, scratch);
+  const EdgeAdjacency& adjacency = scratch.adjacency;
+  size_t num_vertices = adjacency.vertices.size();
+  auto& used = scratch.used;
+  used.assign(edges.size(), 0);
+
+  auto degree = [&adjacency](size_t v) { return adjacency.offsets[v + 1] - adjacency.offsets[v]; };
+  auto hasUnusedEdge = [&adjacency, &used](size_t v) {
+    for (uint32_t i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; i++) {
+      if (!used[adjacency.edge_ids[i]]) {
+        return true;
+      }
+    }
+    return false;
+  };
 
-  // Find connected components
-  for (const auto& entry : adjList) {
-    // Go through each node that hasn't been finished yet
-    size_t node = entry.first;
-    if (finished.find(node) == finished.end()) {
-      std::vector<size_t> currentPath;
-      edgeDfs(node, adjList, visited, finished, currentPath, paths);
+  // Open chain ends first, so chains run end to end instead of starting midway
+  for (size_t v = 0; v < num_vertices; v++) {
+    if (degree(v) == 1 && hasUnusedEdge(v)) {
+      chainEdges(static_cast<uint32_t>(v), adjacency, positions, used, paths);
     }
   }
-
-  // Split polylines into paths less than the maximum UBO array size defined in MiterOutlineShader.
-  // (prevents seg faulting when rendering due to too many vertices in UBO buffer)
-  int splitLength = (int)maxUBOArraySize - 10;
-  if (splitLength <= 0) {
-    throw std::runtime_error("Polyline split length <= 0. Adjust maxUBOArraySize");
+  // Then branches left over at junctions
+  for (size_t v = 0; v < num_vertices; v++) {
+    while (degree(v) > 2 && hasUnusedEdge(v)) {
+      chainEdges(static_cast<uint32_t>(v), adjacency, positions, used, paths);
+    }
+  }
+  // Anything left is made of closed loops through degree-2 vertices
+  for (size_t v = 0; v < num_vertices; v++) {
+    while (hasUnusedEdge(v)) {
+      chainEdges(static_cast<uint32_t>(v), adjacency, positions, used, paths);
+    }
   }
-  splitPolylines(paths, splitLength);
-
-  return paths;
 }
 
 int main() {
@@ -290,17 +169,23 @@ int main() {
 
   // Has 1 loop (8, 9)
   std::vector<Edge> edges = {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {5, 0}, {8, 9}};
+  PositionArray positions;
+  for (int i = 0; i < 10; i++) {
+    positions.push_back(glm::vec3(i, 0, 0));
+  }
 
-  std::vector<Polyline> polylines = edgesToPolylines(edges);
+  EdgeChainScratch scratch;
+  PolylineSet polylines;
+  edgesToPolylines(edges, positions, scratch, polylines);
 
   // Print the result
-  for (const auto& polyline : polylines) {
+  for (size_t i = 0; i < polylines.GetNumPolylines(); i++) {
     std::cout << "Polyline: ";
-    for (size_t node : polyline.path) {
-      std::cout << node << " ";
+    for (size_t j = 0; j < polylines.GetPathSize(i); j++) {
+      std::cout << polylines.GetPath(i)[j] << " ";
     }
     std::cout << std::endl;
-    std::cout << "Loop: " << (polyline.is_loop ? "True" : "False");
+    std::cout << "Loop: " << (polylines.is_loop[i] ? "True" : "False");
     std::cout << std::endl;
   }
 
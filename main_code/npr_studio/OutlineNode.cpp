@@ -12,8 +12,11 @@
 #include "gloo/components/RenderingComponent.hpp"
 #include "gloo/components/ShadingComponent.hpp"
 #include "gloo/debug/PrimitiveFactory.hpp"
+#include "gloo/shaders/InvertedHullShader.hpp"
 #include "gloo/shaders/MiterOutlineShader.hpp"
 #include "gloo/shaders/OutlineShader.hpp"
+#include "gloo/shaders/ShaderRegistry.hpp"
+#include "gloo/shaders/SilhouetteShader.hpp"
 #include "gloo/shaders/SimpleShader.hpp"
 #include "gloo/shaders/ToneMappingShader.hpp"
 #include "gloo/shaders/ToonShader.hpp"
@@ -37,11 +40,8 @@ OutlineNode::OutlineNode(const Scene* scene, const std::shared_ptr<VertexObject>
 
   // Outline Specific Setup:
   SetupEdgeMaps();
-  // Precompute Border and Crease Edges:
-  ComputeBorderEdges();
-  ComputeCreaseEdges();
-  // Compute silhouette edges for first frame
-  ComputeSilhouetteEdges();
+  // Precompute Crease Edges, along with the silhouette edges for the first frame
+  UpdateEdgeTypes(kSilhouetteEdgeBit | kCreaseEdgeBit);
 }
 
 OutlineNode::OutlineNode(const Scene* scene, const std::shared_ptr<VertexObject> mesh,
@@ -76,11 +76,8 @@ OutlineNode::OutlineNode(const Scene* scene, const std::shared_ptr<VertexObject>
 
   // Outline Specific Setup:
   SetupEdgeMaps();
-  // Precompute Border and Crease Edges:
-  ComputeBorderEdges();
-  ComputeCreaseEdges();
-  // Compute silhouette edges for first frame
-  ComputeSilhouetteEdges();
+  // Precompute Crease Edges, along with the silhouette edges for the first frame
+  UpdateEdgeTypes(kSilhouetteEdgeBit | kCreaseEdgeBit);
 }
 
 void OutlineNode::SetOutlineMesh() {
@@ -101,19 +98,29 @@ void OutlineNode::SetOutlineMesh() {
 }
 
 void OutlineNode::DoRenderSetup(std::shared_ptr<ShaderProgram> mesh_shader) {
-  // Create new tone mapping shader if shader isn't specified
-  mesh_shader_ = mesh_shader == nullptr ? std::make_shared<ToneMappingShader>() : mesh_shader;
-  // Create outline shader
-  outline_shader_ = std::make_shared<OutlineShader>();
+  // Use the shared tone mapping shader if shader isn't specified
+  mesh_shader_ = mesh_shader == nullptr ? GetSharedShader<ToneMappingShader>() : mesh_shader;
+  // Outline shader, shared by all nodes
+  outline_shader_ = GetSharedShader<OutlineShader>();
   CreateComponent<ShadingComponent>(outline_shader_);
   auto& rc_node = CreateComponent<RenderingComponent>(outline_mesh_);
   rc_node.SetDrawMode(DrawMode::Lines);
 
-  // Create miter outline shader
+  // Create miter outline shader. Unlike the other outline shaders it isn't shared, since it keeps
+  // the node's projected points between passes.
   miter_outline_shader_ = std::make_shared<MiterOutlineShader>();
 
   // Outline Material (default NPR)
-  CreateComponent<MaterialComponent>(std::make_shared<Material>(Material::GetDefaultNPR()));
+  auto outlineMaterial = std::make_shared<Material>(Material::GetDefaultNPR());
+  CreateComponent<MaterialComponent>(outlineMaterial);
+  outline_material_ = outlineMaterial;
+
+  // Child Scene Node drawing all miter polylines, which is reused for every edge update
+  auto polylineNode = make_unique<PolylineNode>(PolylineSet(), PositionArray(),
+                                                outlineMaterial, miter_outline_shader_);
+  polylineNode->SetActive(false);
+  polyline_node_ = polylineNode.get();
+  AddChild(std::move(polylineNode));
 
   // Child Scene Node for actual mesh
   auto meshNode = make_unique<SceneNode>();
@@ -137,11 +144,11 @@ void OutlineNode::SetBorderStatus(bool status) {
 }
 
 void OutlineNode::ChangeMeshShader(ToonShadingType shadingType) {
-  // Create entirely new shader and assign it to mesh
+  // Assign the shader shared by all nodes with this shading type to the mesh
   if (shadingType == ToonShadingType::TOON) {
-    mesh_shader_ = std::make_shared<ToonShader>();
+    mesh_shader_ = GetSharedShader<ToonShader>();
   } else {
-    mesh_shader_ = std::make_shared<ToneMappingShader>();
+    mesh_shader_ = GetSharedShader<ToneMappingShader>();
   }
   mesh_node_->GetComponentPtr<ShadingComponent>()->SetShader(mesh_shader_);
 }
@@ -161,7 +168,9 @@ void OutlineNode::ChangeMeshShader(std::shared_ptr<ShaderProgram> shader) {
 void OutlineNode::SetCreaseThreshold(float degrees) {
   update_crease_ = true;  // set crease edges to be re-rendered next render cycle
   crease_threshold_ = glm::radians(degrees);
-  ComputeCreaseEdges();
+  // Reclassified on the next Update(), so dragging the threshold slider only costs one binary
+  // search per frame
+  pending_edge_types_ |= kCreaseEdgeBit;
 }
 
 void OutlineNode::SetIlluminatedColor(const glm::vec3& color) {
@@ -183,7 +192,7 @@ void OutlineNode::SetOutlineColor(const glm::vec3& color) {
   auto material_ptr = std::make_shared<Material>(material);
   GetComponentPtr<MaterialComponent>()->SetMaterial(material_ptr);
   // Update polyline outline nodes
-  UpdatePolylineNodeMaterials(material_ptr);
+  UpdateOutlineNodeMaterials(material_ptr);
 }
 
 void OutlineNode::OverrideNPRColorsFromDiffuse(float illuminationFactor, float shadowFactor,
@@ -210,7 +219,7 @@ void OutlineNode::SetOutlineThickness(const float& width) {
   auto material_ptr = std::make_shared<Material>(material);
   GetComponentPtr<MaterialComponent>()->SetMaterial(material_ptr);
   // Update polyline outline nodes
-  UpdatePolylineNodeMaterials(material_ptr);
+  UpdateOutlineNodeMaterials(material_ptr);
 }
 
 void OutlineNode::SetDiffuseIntensity(const float& intensity) {
@@ -257,17 +266,32 @@ Material OutlineNode::GetMeshMaterial() {
 
 void OutlineNode::SetOutlineMethod(OutlineMethod method) {
   update_outline_method_ = outline_method_ != method;
+  // CPU silhouettes aren't kept up to date by the other methods, so recompute them when switching
+  // back.
+  bool cpu_method =
+      outline_method_ == OutlineMethod::STANDARD || outline_method_ == OutlineMethod::MITER;
+  if (!cpu_method && update_outline_method_) {
+    update_silhouette_ = true;
+  }
   outline_method_ = method;
 }
 
 void OutlineNode::SetMeshVisibility(bool visible) { mesh_node_->SetActive(visible); }
 void OutlineNode::SetPerformanceModeStatus(bool enabled) { enable_performance_mode_ = enabled; }
 void OutlineNode::SetEdgeSimplifyStatus(bool enabled) { edge_simplify_status_ = enabled; }
-void OutlineNode::SetEdgeSimplifyThreshold(float minPixelDistance) {
-  edge_simplify_threshold_ = minPixelDistance;
+void OutlineNode::SetEdgeSimplifyThreshold(float tolerancePixels) {
+  edge_simplify_threshold_ = tolerancePixels;
+}
+void OutlineNode::SetSilhouetteCacheStatus(bool enabled) {
+  if (enabled == (silhouette_cache_ != nullptr)) {
+    return;
+  }
+  silhouette_cache_ = enabled ? make_unique<SilhouetteCache>() : nullptr;
+  // Snap (or unsnap) the current silhouette to the cache's view directions
+  update_silhouette_ = true;
 }
 
-void OutlineNode::CalculateFaceDirections() {
+glm::vec3 OutlineNode::GetLocalCameraDirection() const {
   // TODO: this is treated as an orthographic projection, try doing this with persepctive projection
   // Can try using projection matrix of camera?
   // Get camera information
@@ -277,11 +301,56 @@ void OutlineNode::CalculateFaceDirections() {
       glm::vec3(glm::inverse(camera_pointer->GetViewMatrix()) * glm::vec4(0.0f, 0.0f, 1.0f, 0.0f));
 
   // Transform global camera direction into object coordinates
-  glm::vec3 local_camera_direction = glm::inverse(GetTransform().GetLocalToWorldMatrix()) *
-                                     glm::vec4(global_camera_direction, 0.0f);
-  // Iterate through faces and calculate if they're pointing towards or away the camera
-  for (auto face : faces_) {
-    face->front_facing = glm::dot(face->normal, local_camera_direction) >= 0;
+  return glm::inverse(GetTransform().GetLocalToWorldMatrix()) *
+         glm::vec4(global_camera_direction, 0.0f);
+}
+
+void OutlineNode::CalculateFaceDirections(const glm::vec3& local_camera_direction,
+                                          bool frustum_cull) {
+  // Classify face clusters against the view direction (and frustum); only faces of clusters that
+  // could contain silhouettes get their facing computed.
+  if (frustum_cull) {
+    auto camera_pointer = parent_scene_->GetActiveCameraPtr();
+    glm::mat4 object_to_clip = camera_pointer->GetProjectionMatrix() *
+                               camera_pointer->GetViewMatrix() *
+                               GetTransform().GetLocalToWorldMatrix();
+    cone_hierarchy_.ClassifyClusters(topology_, local_camera_direction, object_to_clip,
+                                     face_front_facing_);
+  } else {
+    cone_hierarchy_.ClassifyClusters(topology_, local_camera_direction, face_front_facing_);
+  }
+}
+
+void OutlineNode::UpdateSilhouetteEdges() {
+  glm::vec3 local_camera_direction = GetLocalCameraDirection();
+  if (silhouette_cache_ != nullptr) {
+    // Cached silhouettes are computed for the center of the view direction's cell, so repeat
+    // views give the same result whether they hit the cache or not.
+    uint32_t cell = silhouette_cache_->GetCell(local_camera_direction);
+    if (!silhouette_cache_->Lookup(cell, silhouette_edges_)) {
+      CalculateFaceDirections(silhouette_cache_->GetCellDirection(cell), false);
+      silhouette_edges_.clear();
+      cone_hierarchy_.FindSilhouetteEdges(topology_, face_front_facing_, silhouette_edges_);
+      silhouette_cache_->Insert(cell, silhouette_edges_);
+    }
+    silhouette_tracker_.Clear();
+    return;
+  }
+  // While orbiting, consecutive silhouettes are nearly identical, so follow them from the last
+  // frame's edges. The tracker refuses large camera jumps, which get a full sweep instead.
+  if (is_camera_moving_ &&
+      silhouette_tracker_.Update(topology_, local_camera_direction, silhouette_edges_)) {
+    return;
+  }
+  // The tracker can only follow silhouettes it was seeded with, so don't cull off-screen clusters
+  // when seeding it.
+  CalculateFaceDirections(local_camera_direction, !is_camera_moving_);
+  silhouette_edges_.clear();
+  cone_hierarchy_.FindSilhouetteEdges(topology_, face_front_facing_, silhouette_edges_);
+  if (is_camera_moving_) {
+    silhouette_tracker_.Reset(topology_, local_camera_direction, silhouette_edges_);
+  } else {
+    silhouette_tracker_.Clear();
   }
 }
 
@@ -300,16 +369,33 @@ void OutlineNode::Update(double delta_time) {
 
   // Silhouette edges should be rerenedered if we've changed their status (original variable value)
   // or if the camera has moved (is_camera_moving_).
-  update_silhouette_ = update_silhouette_ || is_camera_moving_;
+  // Once the camera comes to rest, do one more full sweep to pick up silhouettes the incremental
+  // tracker can't see (e.g. ones that appeared away from existing silhouettes).
+  // With GPU silhouettes, camera motion doesn't need any CPU edge work, and GPU lines only need
+  // their compaction pass to run again.
+  OutlineMethod method = GetActiveOutlineMethod();
+  bool cpu_silhouettes = method == OutlineMethod::STANDARD || method == OutlineMethod::MITER;
+  bool view_dependent = cpu_silhouettes || method == OutlineMethod::GPU_LINES;
+  update_silhouette_ = update_silhouette_ || (view_dependent && (is_camera_moving_ || staticFrame));
 
   // On each frame, recaclulate the silhouette edges and draw all updated edges, but
   // only recalculate silhouette edges when we're displaying them and the camera isn't moving, or if
   // we've toggled silhouette edges on
-  if (show_silhouette_edges_ && update_silhouette_) {
-    ComputeSilhouetteEdges();
+  if (show_silhouette_edges_ && update_silhouette_ && cpu_silhouettes) {
+    pending_edge_types_ |= kSilhouetteEdgeBit;
+  }
+  if (pending_edge_types_ != 0) {
+    UpdateEdgeTypes(pending_edge_types_);
+    pending_edge_types_ = 0;
   }
 
   RenderEdges();
+  // GPU line results arrive a frame or so after they're requested, keep picking them up even once
+  // the camera stops.
+  if (GetActiveOutlineMethod() == OutlineMethod::GPU_LINES && edge_compaction_shader_ != nullptr &&
+      edge_compaction_shader_->HasPendingResult()) {
+    FetchCompactedEdges();
+  }
 
   // Now that we've updated and rendered our edges, we don't need to do it again.
   update_silhouette_ = false;
@@ -327,104 +413,120 @@ void OutlineNode::RenderEdges() {
     std::cout << std::chrono::system_clock::now().time_since_epoch().count() << ": updating edges!"
               << std::endl;
   }
-  auto newIndices = make_unique<IndexArray>();
-  // Render miter join edges in passes
-  auto renderedSilhouetteEdges = std::vector<Edge>();
-  auto renderedCreaseEdges = std::vector<Edge>();
-  auto renderedBorderEdges = std::vector<Edge>();
-
-  // Update lists of rendered edges if any of them need to be updated
-
-  // Only iterate through our edges if we're going to draw any of them
-  if (show_silhouette_edges_ || show_border_edges_ || show_crease_edges_) {
-    for (const auto& item : edge_info_map_) {
-      Edge edge = item.first;
-      EdgeInfo info = item.second;
-      // Only draw edges that we allow
-      if ((info.is_silhouette && show_silhouette_edges_) ||
-          (info.is_border && show_border_edges_) || (info.is_crease && show_crease_edges_)) {
-        // Toggle between rendering with miter joins and "fast" edge rendering
-        // In performance mode, only render miter joins when the camera isn't moving
-        if (outline_method_ == OutlineMethod::STANDARD ||
-            (is_camera_moving_ && enable_performance_mode_)) {
-          newIndices->push_back(edge.first);
-          newIndices->push_back(edge.second);
-        } else if (outline_method_ == OutlineMethod::MITER) {
-          // record edges of each type for polyline drawing purposes
-          if (info.is_silhouette && show_silhouette_edges_) {
-            renderedSilhouetteEdges.push_back(edge);
-          }
-          if (info.is_border && show_border_edges_) {
-            renderedBorderEdges.push_back(edge);
-          }
-          if (info.is_crease && show_crease_edges_) {
-            renderedCreaseEdges.push_back(edge);
-          }
-        }
+  OutlineMethod method = GetActiveOutlineMethod();
+  if (method == OutlineMethod::INVERTED_HULL) {
+    SetupHullMesh();
+  }
+  // The hull only shows the outer silhouette, so it follows the silhouette toggle
+  if (hull_node_ != nullptr) {
+    hull_node_->SetActive(method == OutlineMethod::INVERTED_HULL && show_silhouette_edges_);
+  }
+  if (method == OutlineMethod::SCREEN_SPACE || method == OutlineMethod::SCREEN_SPACE_JUMP_FLOOD ||
+      method == OutlineMethod::INVERTED_HULL) {
+    // Screen space outlines are drawn by the renderer
+    HideEdges();
+    return;
+  }
+  if (method == OutlineMethod::GPU_LINES) {
+    CompactEdgesOnGpu();
+    if (gpu_silhouette_node_ != nullptr) {
+      gpu_silhouette_node_->SetActive(false);
+    }
+    polyline_node_->SetActive(false);
+    return;
+  }
+  // Back to CPU built indices, which are drawn in full
+  GetComponentPtr<RenderingComponent>()->SetDrawRange(-1, -1);
+  // Toggle between rendering with miter joins and "fast" edge rendering
+  bool gpu_silhouettes = method == OutlineMethod::GPU_SILHOUETTE;
+  bool draw_lines = method == OutlineMethod::STANDARD || gpu_silhouettes;
+  if (gpu_silhouettes && show_silhouette_edges_) {
+    SetupAdjacencyMesh();
+  }
+  if (gpu_silhouette_node_ != nullptr) {
+    gpu_silhouette_node_->SetActive(gpu_silhouettes && show_silhouette_edges_);
+  }
+  auto edgeOf = [this](uint32_t e) {
+    return Edge(topology_.GetEdgeVertex(e, 0), topology_.GetEdgeVertex(e, 1));
+  };
+  // Crease and border edges are drawn by the static edge range
+  auto isStaticEdgeShown = [this](uint32_t e) {
+    return ((edge_flags_[e] & kCreaseEdgeBit) && show_crease_edges_) ||
+           ((edge_flags_[e] & kBorderEdgeBit) && show_border_edges_);
+  };
+  const uint32_t* creaseEdges = crease_index_.GetCreaseEdges();
+  size_t numCreaseEdges = show_crease_edges_ ? crease_index_.GetNumCreaseEdges() : 0;
+  size_t numBorderEdges = show_border_edges_ ? border_edges_.size() : 0;
+  size_t numSilhouetteEdges =
+      show_silhouette_edges_ && !gpu_silhouettes ? silhouette_edges_.size() : 0;
+
+  // Line outlines keep crease and border edges at the front of the index buffer. They only change
+  // with their toggles, the crease threshold or the outline method, so while the camera moves only
+  // the silhouette indices after them are streamed.
+  static_outline_dirty_ =
+      static_outline_dirty_ || update_crease_ || update_border_ || update_outline_method_;
+  size_t firstChangedIndex = 0;
+  outline_index_scratch_.clear();
+  polylines_.Clear();
+  auto& positions = outline_mesh_->GetPositions();
+  if (draw_lines) {
+    if (static_outline_dirty_) {
+      for (size_t i = 0; i < numCreaseEdges; i++) {
+        outline_index_scratch_.push_back(topology_.GetEdgeVertex(creaseEdges[i], 0));
+        outline_index_scratch_.push_back(topology_.GetEdgeVertex(creaseEdges[i], 1));
       }
+      for (size_t i = 0; i < numBorderEdges; i++) {
+        // Border edges never have two faces, so they can't also be creases
+        outline_index_scratch_.push_back(topology_.GetEdgeVertex(border_edges_[i], 0));
+        outline_index_scratch_.push_back(topology_.GetEdgeVertex(border_edges_[i], 1));
+      }
+      num_static_outline_indices_ = outline_index_scratch_.size();
+    } else {
+      firstChangedIndex = num_static_outline_indices_;
     }
+    for (size_t i = 0; i < numSilhouetteEdges; i++) {
+      uint32_t e = silhouette_edges_[i];
+      if (!isStaticEdgeShown(e)) {
+        outline_index_scratch_.push_back(topology_.GetEdgeVertex(e, 0));
+        outline_index_scratch_.push_back(topology_.GetEdgeVertex(e, 1));
+      }
+    }
+  } else if (method == OutlineMethod::MITER) {
+    // Chain the edges of each type into polylines for miter drawing. Types are chained separately
+    // so polylines don't run from one type into another.
+    auto chainEdges = [&](const uint32_t* edge_ids, size_t num_edges) {
+      polyline_edges_.clear();
+      for (size_t i = 0; i < num_edges; i++) {
+        polyline_edges_.push_back(edgeOf(edge_ids[i]));
+      }
+      edgesToPolylines(polyline_edges_, positions, edge_chain_scratch_, polylines_);
+    };
+    chainEdges(silhouette_edges_.data(), numSilhouetteEdges);
+    chainEdges(creaseEdges, numCreaseEdges);
+    chainEdges(border_edges_.data(), numBorderEdges);
   }
   // Update outline mesh with new indices
-  outline_mesh_->UpdateIndices(std::move(newIndices));
-
-  // Reset Polyline edge nodes
-  // TODO: Polyline node arrays for each edge type (so you can turn them on and off?)
-  for (auto& polylineNode : polyline_nodes_) {
-    polylineNode->SetActive(false);
+  outline_mesh_->UpdateIndexRange(firstChangedIndex, outline_index_scratch_);
+  // The static range is dropped while lines aren't drawn, so rebuild it once they are again
+  static_outline_dirty_ = !draw_lines;
+
+  // Render polylines if we're doing the miter join method. All polylines are drawn by one node
+  // with a single multi-draw call.
+  if (polylines_.GetNumPolylines() != 0 && debug_) {
+    std::cout << "Num Polylines: " << polylines_.GetNumPolylines() << std::endl;
   }
-
-  // Render polylines if we're doing the miter join method
-  // TODO:
-  // Keep PolylineGroups as a cache of each type of edge, and actually only add each edge type of
-  // polylineGroups if they're being rendered
-  // If we're updating edges, use global border and crease edge polyline caches and update silhoutte
-  // edges dynamically
-  std::vector<std::vector<Polyline>> polylineGroups = {edgesToPolylines(renderedSilhouetteEdges),
-                                                       edgesToPolylines(renderedCreaseEdges),
-                                                       edgesToPolylines(renderedBorderEdges)};
-
-  auto& positions = outline_mesh_->GetPositions();
   // Simplify polylines
   if (edge_simplify_status_) {
-    // Simplify and split polylines
     auto cameraPointer = parent_scene_->GetActiveCameraPtr();
     glm::vec2 window_size = InputManager::GetInstance().GetWindowSize();
-    glm::mat4 model_matrix = GetTransform().GetLocalToWorldMatrix();
-    for (auto& polylines : polylineGroups) {
-      simplifyPolylines(polylines, positions, edge_simplify_threshold_, cameraPointer, window_size,
-                        model_matrix);
-    }
-  }
-
-  auto material = GetComponentPtr<MaterialComponent>()->GetMaterial();
-  auto material_ptr = std::make_shared<Material>(material);
-  // Render polylines in passes
-  // keep a global tracker of how many polylines we've currently rendered
-  size_t polylineCounter = 0;
-  for (auto& polylines : polylineGroups) {
-    if (polylines.size() != 0 && debug_) {
-      std::cout << "Num Polylines: " << polylines.size() << std::endl;
-    }
-    size_t lastPassPolylines =
-        polylineCounter;  // tracks how many polylines we've rendered up to the previous pass
-    for (; (polylineCounter - lastPassPolylines) < polylines.size(); ++polylineCounter) {
-      auto& polyline = polylines[polylineCounter - lastPassPolylines];
-      // Reuse edge nodes if we can
-      PolylineNode* polylineNode;
-      if (polyline_nodes_.size() > polylineCounter) {
-        // Update old polyline node
-        polylineNode = polyline_nodes_[polylineCounter];
-        polylineNode->SetPolyline(polyline, positions);
-        polylineNode->SetActive(true);
-      } else {
-        // Make a new polyline node
-        auto newPolylineNode =
-            make_unique<PolylineNode>(polyline, positions, material_ptr, miter_outline_shader_);
-        polyline_nodes_.push_back(newPolylineNode.get());
-        AddChild(std::move(newPolylineNode));
-      }
-    }
+    glm::mat4 object_to_clip = cameraPointer->GetProjectionMatrix() *
+                               cameraPointer->GetViewMatrix() *
+                               GetTransform().GetLocalToWorldMatrix();
+    polyline_simplifier_.Simplify(polylines_, positions, object_to_clip, window_size,
+                                  edge_simplify_threshold_);
   }
+  polyline_node_->SetPolylines(polylines_, positions);
+  polyline_node_->SetActive(polylines_.GetNumPolylines() != 0);
 }
 
 void PrintEdge(Edge edge) {
@@ -432,120 +534,211 @@ void PrintEdge(Edge edge) {
 }
 
 void OutlineNode::SetupEdgeMaps() {
-  IndexArray indices = mesh_->GetIndices();
-  PositionArray positions = mesh_->GetPositions();
-  // Enforce Precondition, we should be dealing with a regular mesh.
-  if (indices.size() % 3 != 0) {
-    throw std::runtime_error("Mesh should be made fully out of triangles!");
-  }
-
-  // Traverse Indices of Groups of 3, processing a face each time
-  for (size_t i = 0; i < indices.size(); i += 3) {
-    size_t i1 = indices[i];
-    size_t i2 = indices[i + 1];
-    size_t i3 = indices[i + 2];
-
-    // Face normal calculations
-    auto& p1 = positions[i1];
-    auto& p2 = positions[i2];
-    auto& p3 = positions[i3];
-    auto face_normal = glm::normalize(glm::cross(p2 - p1, p3 - p1));
-
-    // Define Face
-    std::shared_ptr<Face> face = std::make_shared<Face>();
-    face->i1 = i1;
-    face->i2 = i2;
-    face->i3 = i3;
-    face->normal = face_normal;
-
-    faces_.push_back(face);
-
-    // Define Edges on Face
-    Edge edge1(i1, i2);
-    Edge edge2(i2, i3);
-    Edge edge3(i3, i1);
-    std::vector<Edge> edges = {edge1, edge2, edge3};
-    // Initialize edges in edge info and edge face maps
-    for (auto& edge : edges) {
-      // Edge info map
-      if (edge_info_map_.count(edge) == 0) {
-        EdgeInfo edge_info;
-        edge_info.is_border = false;
-        edge_info.is_crease = false;
-        edge_info.is_silhouette = false;
-        edge_info_map_[edge] = edge_info;
-      }
-
-      // Edge face map
-      edge_face_map_[edge].push_back(face);
+  // Sort-build the edge/face adjacency once; every edge pass afterwards walks flat arrays.
+  topology_.Build(mesh_->GetPositions(), mesh_->GetIndices());
+  edge_flags_.assign(topology_.GetNumEdges(), 0);
+  face_front_facing_.assign(topology_.GetNumFaces(), 0);
+  crease_index_.Build(topology_);
+  cone_hierarchy_.Build(topology_, mesh_->GetPositions());
+  // Border edges only lie on the edge of a single polygon (Lake et al. 2000), so they never
+  // change after the mesh is set
+  border_edges_.clear();
+  for (size_t e = 0; e < topology_.GetNumEdges(); e++) {
+    if (topology_.GetEdgeFaceCount(e) == 1) {
+      border_edges_.push_back(static_cast<uint32_t>(e));
+      edge_flags_[e] = kBorderEdgeBit;
     }
   }
+  static_outline_dirty_ = true;
+  adjacency_mesh_dirty_ = true;
+  compaction_edges_dirty_ = true;
+  silhouette_edges_.clear();
+  silhouette_tracker_.Clear();
+  if (silhouette_cache_ != nullptr) {
+    silhouette_cache_->Clear();
+  }
 }
 
-void OutlineNode::ComputeBorderEdges() {
-  // From Lake et al. (2000), Border edges only lie on the edge of a single polygon
-  // Note: if we had support for multiple materials
-  // for an object we'd also have to account for that
-  for (const auto& item : edge_face_map_) {
-    Edge edge = item.first;
-    auto faces = item.second;
-    if (faces.size() == 1) {
-      edge_info_map_[edge].is_border = true;
-      //   std::cout << "Border Edge:";
-      //   PrintEdge(edge);
-    } else {
-      edge_info_map_[edge].is_border = false;
+void OutlineNode::SetupAdjacencyMesh() {
+  if (!adjacency_mesh_dirty_) {
+    return;
+  }
+  // The GPU silhouette node (and its copy of the outline positions) is only created once the
+  // method is first used.
+  bool create_node = gpu_silhouette_node_ == nullptr;
+  if (create_node) {
+    adjacency_mesh_ = std::make_shared<VertexObject>();
+  }
+  adjacency_mesh_->UpdatePositions(make_unique<PositionArray>(outline_mesh_->GetPositions()));
+
+  // GL_TRIANGLES_ADJACENCY wants each triangle's vertices interleaved with the far corners of the
+  // triangles across its edges. Border edges repeat their own first vertex, which gives a
+  // degenerate neighbor that SilhouetteShader never treats as back facing.
+  auto indices = make_unique<IndexArray>();
+  indices->reserve(6 * topology_.GetNumFaces());
+  for (size_t f = 0; f < topology_.GetNumFaces(); f++) {
+    for (int i = 0; i < 3; i++) {
+      uint32_t a = topology_.GetFaceVertex(f, i);
+      uint32_t b = topology_.GetFaceVertex(f, (i + 1) % 3);
+      uint32_t e = topology_.GetFaceEdge(f, i);
+      uint32_t neighbor = topology_.GetEdgeFace(e, 0) == f ? topology_.GetEdgeFace(e, 1)
+                                                             : topology_.GetEdgeFace(e, 0);
+      uint32_t far_corner = a;
+      if (neighbor != kNoFace) {
+        for (int k = 0; k < 3; k++) {
+          uint32_t v = topology_.GetFaceVertex(neighbor, k);
+          if (v != a && v != b) {
+            far_corner = v;
+          }
+        }
+      }
+      indices->push_back(a);
+      indices->push_back(far_corner);
     }
   }
+  adjacency_mesh_->UpdateIndices(std::move(indices));
+  adjacency_mesh_dirty_ = false;
+
+  if (create_node) {
+    auto silhouetteNode = make_unique<SceneNode>();
+    auto& rc_silhouette = silhouetteNode->CreateComponent<RenderingComponent>(adjacency_mesh_);
+    rc_silhouette.SetDrawMode(DrawMode::TrianglesAdjacency);
+    silhouetteNode->CreateComponent<ShadingComponent>(GetSharedShader<SilhouetteShader>());
+    silhouetteNode->CreateComponent<MaterialComponent>(outline_material_);
+    silhouetteNode->SetActive(false);
+    gpu_silhouette_node_ = silhouetteNode.get();
+    AddChild(std::move(silhouetteNode));
+  }
+}
+
+OutlineMethod OutlineNode::GetActiveOutlineMethod() const {
+  bool cpu_method =
+      outline_method_ == OutlineMethod::STANDARD || outline_method_ == OutlineMethod::MITER;
+  if (cpu_method && enable_performance_mode_ && is_camera_moving_) {
+    return OutlineMethod::INVERTED_HULL;
+  }
+  return outline_method_;
 }
 
-void OutlineNode::ComputeCreaseEdges() {
-  // From Lake et al. (2000), A crease edge is detected when the dihedral angle between two faces is
-  // greater than a given threshold.
-  for (const auto& item : edge_face_map_) {
-    Edge edge = item.first;
-    auto faces = item.second;
-    if (faces.size() != 2) {
-      edge_info_map_[edge].is_crease = false;
-      continue;
+void OutlineNode::HideEdges() {
+  outline_index_scratch_.clear();
+  outline_mesh_->UpdateIndexRange(0, outline_index_scratch_);
+  static_outline_dirty_ = true;
+  GetComponentPtr<RenderingComponent>()->SetDrawRange(-1, -1);
+  if (gpu_silhouette_node_ != nullptr) {
+    gpu_silhouette_node_->SetActive(false);
+  }
+  polyline_node_->SetActive(false);
+}
+
+void OutlineNode::SetupHullMesh() {
+  if (hull_node_ != nullptr) {
+    return;
+  }
+  // The hull draws the mesh's own buffers (SetOutlineMesh() made sure it has normals); attribute
+  // locations are fixed, so the lit shaders and the hull shader link them the same way. Only the
+  // node and its shader are created here, once the method is first used.
+  auto hullNode = make_unique<SceneNode>();
+  auto& rc_hull = hullNode->CreateComponent<RenderingComponent>(mesh_);
+  rc_hull.SetCullMode(CullMode::Front);
+  hullNode->CreateComponent<ShadingComponent>(GetSharedShader<InvertedHullShader>());
+  hullNode->CreateComponent<MaterialComponent>(outline_material_);
+  hullNode->SetActive(false);
+  hull_node_ = hullNode.get();
+  AddChild(std::move(hullNode));
+}
+
+void OutlineNode::CompactEdgesOnGpu() {
+  // The index buffer is written on the GPU from here on, so drop the CPU copy and have the CPU
+  // path rebuild everything once it's used again.
+  outline_index_scratch_.clear();
+  outline_mesh_->UpdateIndexRange(0, outline_index_scratch_);
+  static_outline_dirty_ = true;
+
+  if (edge_compaction_shader_ == nullptr) {
+    edge_compaction_shader_ = make_unique<EdgeCompactionShader>();
+  }
+  if (compaction_edges_dirty_) {
+    // Each edge can only ever be the types its face count allows
+    std::vector<uint8_t> edge_types(topology_.GetNumEdges(), 0);
+    for (size_t e = 0; e < topology_.GetNumEdges(); e++) {
+      if (topology_.GetEdgeFaceCount(e) == 1) {
+        edge_types[e] = kBorderEdgeBit;
+      } else if (topology_.GetEdgeFaceCount(e) == 2) {
+        edge_types[e] = kSilhouetteEdgeBit | kCreaseEdgeBit;
+      }
     }
-    glm::vec3 face1_n = faces[0]->normal;
-    glm::vec3 face2_n = faces[1]->normal;
-    float angleBetween =
-        glm::acos(glm::dot(face1_n, face2_n) / (glm::length(face1_n) * glm::length(face2_n)));
-    if (angleBetween > crease_threshold_) {
-      edge_info_map_[edge].is_crease = true;
-      //   std::cout << "Crease Edge:";
-      //   PrintEdge(edge);
-    } else {
-      edge_info_map_[edge].is_crease = false;
+    auto& positions = mesh_->GetPositions();
+    std::vector<glm::vec4> face_planes(topology_.GetNumFaces());
+    for (size_t f = 0; f < topology_.GetNumFaces(); f++) {
+      glm::vec3 normal = topology_.GetFaceNormal(f);
+      face_planes[f] =
+          glm::vec4(normal, -glm::dot(normal, positions[topology_.GetFaceVertex(f, 0)]));
     }
+    edge_compaction_shader_->SetEdges(topology_.GetEdgeVertices(), topology_.GetEdgeFaces(),
+                                      edge_types, face_planes);
+    outline_mesh_->GetVertexArray().ReserveIndices(2 * topology_.GetNumEdges());
+    compaction_edges_dirty_ = false;
+    // Reserving discarded the drawn edges, so draw the empty CPU copy until the first result
+    GetComponentPtr<RenderingComponent>()->SetDrawRange(-1, -1);
+  }
+  // Unlike STANDARD, facing is tested against the camera position, i.e. with perspective
+  auto camera_pointer = parent_scene_->GetActiveCameraPtr();
+  glm::vec3 local_eye_position =
+      glm::inverse(camera_pointer->GetViewMatrix() * GetTransform().GetLocalToWorldMatrix()) *
+      glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+  int shown_types = (show_silhouette_edges_ ? kSilhouetteEdgeBit : 0) |
+                    (show_crease_edges_ ? kCreaseEdgeBit : 0) |
+                    (show_border_edges_ ? kBorderEdgeBit : 0);
+  edge_compaction_shader_->Compact(local_eye_position, glm::cos(crease_threshold_), shown_types);
+  FetchCompactedEdges();
+}
+
+void OutlineNode::FetchCompactedEdges() {
+  size_t num_edges;
+  if (!edge_compaction_shader_->FetchResult(
+          outline_mesh_->GetVertexArray().GetIndexBufferHandle(), num_edges)) {
+    return;
+  }
+  // With no edges, the empty CPU index copy makes the full range draw nothing
+  if (num_edges == 0) {
+    GetComponentPtr<RenderingComponent>()->SetDrawRange(-1, -1);
+  } else {
+    GetComponentPtr<RenderingComponent>()->SetDrawRange(0, static_cast<int>(2 * num_edges));
   }
 }
 
-void OutlineNode::ComputeSilhouetteEdges() {
-  // From Lake et al. (2000), an edge is marked as a silhouette edge if a front-facing and a
-  // back-facing polygon share the edge.
-  CalculateFaceDirections();
-  for (const auto& item : edge_face_map_) {
-    Edge edge = item.first;
-    auto faces = item.second;
-    if (faces.size() != 2) {
-      edge_info_map_[edge].is_silhouette = false;
-      continue;
+void OutlineNode::UpdateEdgeTypes(uint8_t edge_types) {
+  // From Lake et al. (2000):
+  // - A crease edge is detected when the dihedral angle between two faces is greater than a given
+  //   threshold (compared here as cosines, so no acos is needed per edge). Edges are kept sorted
+  //   by angle, so only the ones whose state changes are touched.
+  // - An edge is marked as a silhouette edge if a front-facing and a back-facing polygon share the
+  //   edge.
+  if (edge_types & kSilhouetteEdgeBit) {
+    // Silhouettes come from the cluster hierarchy or the tracker, so only the edges that were
+    // silhouettes last time and the new silhouette edges are touched.
+    for (uint32_t e : silhouette_edges_) {
+      edge_flags_[e] &= ~kSilhouetteEdgeBit;
     }
-    // Perform silhouette edge test
-    if (faces[0]->front_facing != faces[1]->front_facing) {
-      edge_info_map_[edge].is_silhouette = true;
-    } else {
-      edge_info_map_[edge].is_silhouette = false;
+    UpdateSilhouetteEdges();
+    for (uint32_t e : silhouette_edges_) {
+      edge_flags_[e] |= kSilhouetteEdgeBit;
     }
   }
+  if (edge_types & kCreaseEdgeBit) {
+    crease_index_.SetThreshold(glm::cos(crease_threshold_), edge_flags_);
+  }
 }
 
-void OutlineNode::UpdatePolylineNodeMaterials(const std::shared_ptr<Material> material) {
-  for (auto node : polyline_nodes_) {
-    node->SetMaterial(material);
+void OutlineNode::UpdateOutlineNodeMaterials(const std::shared_ptr<Material> material) {
+  outline_material_ = material;
+  polyline_node_->SetMaterial(material);
+  if (gpu_silhouette_node_ != nullptr) {
+    gpu_silhouette_node_->GetComponentPtr<MaterialComponent>()->SetMaterial(material);
+  }
+  if (hull_node_ != nullptr) {
+    hull_node_->GetComponentPtr<MaterialComponent>()->SetMaterial(material);
   }
 }
 }  // namespace GLOO
\ No newline at end of file
@@ -10,8 +10,16 @@
 #include "gloo/Scene.hpp"
 #include "gloo/SceneNode.hpp"
 #include "gloo/VertexObject.hpp"
+#include "gloo/shaders/EdgeCompactionShader.hpp"
 #include "gloo/shaders/OutlineShader.hpp"
 #include "gloo/shaders/ShaderProgram.hpp"
+#include "main_code/common/CreaseIndex.hpp"
+#include "main_code/common/EdgeChainScratch.hpp"
+#include "main_code/common/EdgeTopology.hpp"
+#include "main_code/common/NormalConeHierarchy.hpp"
+#include "main_code/common/PolylineSimplifier.hpp"
+#include "main_code/common/SilhouetteCache.hpp"
+#include "main_code/common/SilhouetteTracker.hpp"
 
 namespace GLOO {
 
@@ -36,23 +44,25 @@ struct KeyEqual {
   }
 };
 
-// Holds information about the three vertices of a face and its normal
-struct Face {
-  size_t i1, i2, i3;
-  glm::vec3 normal;
-  bool front_facing;
-};
-
 // An edge is represented as a pair between two indices
 using Edge = std::pair<size_t, size_t>;
 
-// Holds rendering information about an edge.
-struct EdgeInfo {
-  bool is_silhouette, is_crease, is_border;
-};
-
 enum ToonShadingType { TOON, TONE_MAPPING };
-enum OutlineMethod { STANDARD, MITER };
+// GPU_SILHOUETTE finds silhouettes in a geometry shader (see SilhouetteShader) and draws static
+// crease and border edges like STANDARD. GPU_LINES draws STANDARD lines, but classifies edges and
+// writes their indices on the GPU (see EdgeCompactionShader). With SCREEN_SPACE and
+// SCREEN_SPACE_JUMP_FLOOD the node draws no outlines; the renderer finds them in screen space
+// instead (see ScreenOutlineMode). INVERTED_HULL draws outlines without any edges (see
+// InvertedHullShader).
+enum OutlineMethod {
+  STANDARD,
+  MITER,
+  GPU_SILHOUETTE,
+  GPU_LINES,
+  SCREEN_SPACE,
+  SCREEN_SPACE_JUMP_FLOOD,
+  INVERTED_HULL
+};
 
 /**
  * Class representing an object shaded with outlines.
@@ -97,25 +107,59 @@ class OutlineNode : public SceneNode {
   // Set Performance Mode status
   void SetPerformanceModeStatus(bool enabled);
   void SetEdgeSimplifyStatus(bool enabled);
-  void SetEdgeSimplifyThreshold(float minPixelDistance);
+  // Largest screen distance (in pixels) a simplified polyline may deviate from the original by.
+  void SetEdgeSimplifyThreshold(float tolerancePixels);
+  // Reuse silhouettes of previously seen (quantized) view directions instead of recomputing them.
+  void SetSilhouetteCacheStatus(bool enabled);
 
  private:
   void SetupEdgeMaps();
-  void ComputeBorderEdges();
-  void ComputeCreaseEdges();
-  void ComputeSilhouetteEdges();
+  // Recomputes the given silhouette and crease bits (k*EdgeBit) of edge_flags_. Border bits are
+  // set once in SetupEdgeMaps.
+  void UpdateEdgeTypes(uint8_t edge_types);
   void SetOutlineMesh();
-  void CalculateFaceDirections();
-  void UpdatePolylineNodeMaterials(const std::shared_ptr<Material> material);
+  // Returns the camera's view direction in object coordinates.
+  glm::vec3 GetLocalCameraDirection() const;
+  // Computes face facing for the full silhouette sweep, frustum culling face clusters if asked to.
+  void CalculateFaceDirections(const glm::vec3 &local_camera_direction, bool frustum_cull);
+  // Replaces silhouette_edges_, incrementally while the camera orbits and with a full sweep
+  // otherwise.
+  void UpdateSilhouetteEdges();
+  void UpdateOutlineNodeMaterials(const std::shared_ptr<Material> material);
+  // Returns the method used this frame, which is INVERTED_HULL for CPU edge methods while the
+  // camera moves in performance mode.
+  OutlineMethod GetActiveOutlineMethod() const;
+  // Clears the edges drawn by this node, for methods that don't draw any.
+  void HideEdges();
+  // Creates the inverted hull node, if it isn't already.
+  void SetupHullMesh();
+  // Uploads the mesh with triangle adjacency for GPU_SILHOUETTE (creating its node on first use),
+  // if it isn't already.
+  void SetupAdjacencyMesh();
+  // Requests the indices of all shown edges on the GPU, for GPU_LINES. They're written into
+  // outline_mesh_'s index buffer by FetchCompactedEdges once the pass has finished.
+  void CompactEdgesOnGpu();
+  void FetchCompactedEdges();
   void DoRenderSetup(std::shared_ptr<ShaderProgram> mesh_shader = nullptr);
   void ChangeMaterial(Material material);
   Material GetMeshMaterial();
 
   // Modify outline_mesh_ to give it indices corresponding only to edges of the types that are true.
   void RenderEdges();
-  std::unordered_map<Edge, std::vector<std::shared_ptr<Face>>, pairhash, KeyEqual> edge_face_map_;
-  std::unordered_map<Edge, EdgeInfo, pairhash, KeyEqual> edge_info_map_;
-  std::vector<std::shared_ptr<Face>> faces_;
+  // Flat edge/face adjacency of mesh_, built once in SetupEdgeMaps()
+  EdgeTopology topology_;
+  std::vector<uint8_t> edge_flags_;         // packed k*EdgeBit mask, indexed by topology edge id
+  std::vector<uint8_t> face_front_facing_;  // indexed by topology face id
+  uint8_t pending_edge_types_ = 0;          // edge types to reclassify on the next Update()
+  // Edges sorted by dihedral angle, so threshold changes only touch edges that change state
+  CreaseIndex crease_index_;
+  // Face clusters used to skip uniformly facing and off-screen faces in the silhouette pass
+  NormalConeHierarchy cone_hierarchy_;
+  std::vector<uint32_t> silhouette_edges_;  // ids of the edges currently flagged as silhouettes
+  // Follows silhouettes between frames while the camera is moving
+  SilhouetteTracker silhouette_tracker_;
+  // Silhouettes per view direction, only allocated while enabled
+  std::unique_ptr<SilhouetteCache> silhouette_cache_;
 
   std::shared_ptr<ShaderProgram> mesh_shader_;
   std::shared_ptr<ShaderProgram> outline_shader_;
@@ -123,23 +167,40 @@ class OutlineNode : public SceneNode {
 
   std::shared_ptr<VertexObject> mesh_;
   std::shared_ptr<VertexObject> outline_mesh_;
-  std::vector<PolylineNode *> polyline_nodes_;
+  // Line outline indices are crease and border edges (the static range) followed by silhouettes
+  size_t num_static_outline_indices_ = 0;
+  bool static_outline_dirty_ = true;
+  IndexArray outline_index_scratch_;
+  std::vector<uint32_t> border_edges_;  // ids of edges with a single face, found in SetupEdgeMaps
+  PolylineNode *polyline_node_;  // draws every miter polyline
+  // Shared by the child nodes drawing outlines
+  std::shared_ptr<Material> outline_material_;
+  // Draws adjacency_mesh_ with the silhouette shader for GPU_SILHOUETTE, created on first use
+  SceneNode *gpu_silhouette_node_ = nullptr;
+  std::shared_ptr<VertexObject> adjacency_mesh_;
+  bool adjacency_mesh_dirty_ = true;
+  // Draws mesh_ with the inverted hull shader for INVERTED_HULL, created on first use
+  SceneNode *hull_node_ = nullptr;
+  // Static edge data for GPU_LINES, only uploaded once the method is used
+  std::unique_ptr<EdgeCompactionShader> edge_compaction_shader_;
+  bool compaction_edges_dirty_ = true;
+  // Miter polylines of the current edges, and the buffers used to build them (kept between
+  // updates, so rebuilding polylines while orbiting doesn't allocate)
+  PolylineSet polylines_;
+  std::vector<Edge> polyline_edges_;
+  EdgeChainScratch edge_chain_scratch_;
+  PolylineSimplifier polyline_simplifier_;
 
   // Varaibles telling us when to updae the cache
   bool update_border_, update_crease_, update_silhouette_, update_outline_method_ = true;
   bool is_camera_moving_ = true;
-  // Polyline caches for rendering
-  // TODO: Implement caching polylines.
-  std::vector<Polyline> silhoutte_polyline_cache_;
-  std::vector<Polyline> crease_polyline_cache_;
-  std::vector<Polyline> border_polyline_cache_;
 
   SceneNode *mesh_node_;
 
   bool show_silhouette_edges_ = true;
   bool show_border_edges_ = true;
   bool show_crease_edges_ = true;
-  bool enable_performance_mode_ = false;  // TODO should this just be another OutlineMethod?
+  bool enable_performance_mode_ = false;
   bool edge_simplify_status_ = false;     // TODO should this just be another OutlineMethod?
   OutlineMethod outline_method_ = STANDARD;
 
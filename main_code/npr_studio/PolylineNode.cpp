@@ -15,10 +15,11 @@
 #include "main_code/common/helpers.hpp"
 namespace GLOO {
 
-PolylineNode::PolylineNode(const Polyline& polyline, const PositionArray& meshPositions,
+PolylineNode::PolylineNode(const PolylineSet& polylines,
+                           const PositionArray& meshPositions,
                            const std::shared_ptr<Material>& material,
                            const std::shared_ptr<ShaderProgram>& shader) {
-  SetPolyline(polyline, meshPositions);
+  SetPolylines(polylines, meshPositions);
   // Add materials and shader, using default versions if they're nullptr.
   if (material != nullptr) {
     CreateComponent<MaterialComponent>(material);
@@ -30,21 +31,10 @@ PolylineNode::PolylineNode(const Polyline& polyline, const PositionArray& meshPo
   } else {
     CreateComponent<ShadingComponent>(std::make_shared<MiterOutlineShader>());
   }
-  // Print polyline information
-  // std::cout << "Polyline: ";
-  // for (size_t node : polyline.path) {
-  //   std::cout << node << " ";
-  // }
-  // std::cout << std::endl;
-  // std::cout << "Loop: " << (polyline.is_loop ? "True" : "False");
-  // std::cout << std::endl;
 }
 
-void PolylineNode::SetPolyline(const Polyline& polyline, const PositionArray& meshPositions) {
-  // Copy polyline over.
-  polyline_.path = polyline.path;
-  polyline_.is_loop = polyline.is_loop;
-
+void PolylineNode::SetPolylines(const PolylineSet& polylines,
+                                const PositionArray& meshPositions) {
   // TODO we currently have a problem where the miter joins intersect the existing model geometry
   // and get partially rendered behind it, which might mean we need to increase edge bias? Doesn't
   // seem like it does mcuh though. This is pretty visible in border edges. (Lamp.obj and the
@@ -53,69 +43,74 @@ void PolylineNode::SetPolyline(const Polyline& polyline, const PositionArray& me
   //   TODO multiple connections between vertices aren't represented properly with our polyline
   //   method.
 
-  // Define the polyline size. If the polyline is a loop, there's technically another point from
-  // the back to the front that wasn't incldued, making the polyline one vertex longer.
-  auto polylineSize = polyline_.is_loop ? polyline_.path.size() + 1 : polyline_.path.size();
-  auto numVertices =
-      6 * (polylineSize - 1);  // 6 vertices are rendered in the shader per polyline segment.
-  // Create indices for polyline
-  auto polyLineIndices = make_unique<IndexArray>();
-  auto polylinePositions = make_unique<PositionArray>();
-  for (int i = 0; i < numVertices; ++i) {
-    polyLineIndices->push_back(i);
+  // All polylines share one position buffer. Each polyline's points are padded with a point
+  // before and after them, which act as the tangents of the first and last line segments, and
+  // is drawn as its own range of a multi-draw (see MiterOutlineShader for the vertex layout).
+  if (positions_scratch_ == nullptr) {
+    positions_scratch_ = make_unique<PositionArray>();
   }
-  // Create positions for polyline, adding extra vertices to head or tail if
-  // the polyline is a loop. Note that the first and last indices of the final position array act as
-  // the tangents of the first and last line segments.
-  auto firstElt = polyline_.path.front();
-  auto lastElt = polyline_.path.back();
-  if (polyline_.is_loop) {
-    auto secondElt = polyline_.path[1];
-    // Add first elt to the end, followed by the element immediately after it.
-    polyline_.path.push_back(firstElt);
-    polyline_.path.push_back(secondElt);
-    // Add last element to the beginning
-    polyline_.path.insert(polyline_.path.begin(), lastElt);
-    // Populate Polyline Indices
-    for (auto& index : polyline_.path) {
-      polylinePositions->push_back(meshPositions[index]);
-    }
-  } else {
-    // Populate Polyline Indices based on original path
-    for (auto& index : polyline_.path) {
-      polylinePositions->push_back(meshPositions[index]);
+  auto& polylinePositions = positions_scratch_;
+  auto& firsts = firsts_scratch_;
+  auto& counts = counts_scratch_;
+  polylinePositions->clear();
+  firsts.clear();
+  counts.clear();
+  for (size_t i = 0; i < polylines.GetNumPolylines(); i++) {
+    const uint32_t* path = polylines.GetPath(i);
+    size_t pathSize = polylines.GetPathSize(i);
+    if (pathSize < 2) {
+      continue;
     }
-    // Use the slopes of the line segements connecting to the first and last elements of the
-    // polyline path to populate the first and last points of the position array
-    auto firstEltPos = meshPositions[firstElt];
-    auto secondEltPos = meshPositions[polyline_.path[1]];
-    auto lastEltPos = meshPositions[lastElt];
-    auto secondToLastEltPos = meshPositions[polyline_.path[polyline_.path.size() - 2]];
-    glm::vec3 firstSlope = glm::normalize(secondEltPos - firstEltPos);
-    glm::vec3 lastSlope = glm::normalize(lastEltPos - secondToLastEltPos);
+    bool isLoop = polylines.is_loop[i] != 0;
+    // Define the polyline size. If the polyline is a loop, there's technically another point from
+    // the back to the front that wasn't incldued, making the polyline one vertex longer.
+    size_t polylineSize = isLoop ? pathSize + 1 : pathSize;
+    size_t base = polylinePositions->size();
+    firsts.push_back(static_cast<GLint>(6 * base));
+    // 6 vertices are rendered in the shader per polyline segment.
+    counts.push_back(static_cast<GLsizei>(6 * (polylineSize - 1)));
+
+    auto firstEltPos = meshPositions[path[0]];
+    auto lastEltPos = meshPositions[path[pathSize - 1]];
+    if (isLoop) {
+      // Add last element to the beginning, and the first element to the end, followed by the
+      // element immediately after it.
+      polylinePositions->push_back(lastEltPos);
+      for (size_t j = 0; j < pathSize; j++) {
+        polylinePositions->push_back(meshPositions[path[j]]);
+      }
+      polylinePositions->push_back(firstEltPos);
+      polylinePositions->push_back(meshPositions[path[1]]);
+    } else {
+      // Use the slopes of the line segements connecting to the first and last elements of the
+      // polyline path to populate the first and last points of the position array
+      auto secondEltPos = meshPositions[path[1]];
+      auto secondToLastEltPos = meshPositions[path[pathSize - 2]];
+      glm::vec3 firstSlope = glm::normalize(secondEltPos - firstEltPos);
+      glm::vec3 lastSlope = glm::normalize(lastEltPos - secondToLastEltPos);
 
-    // Insert the new points.
-    polylinePositions->push_back(lastEltPos + lastSlope);
-    polylinePositions->insert(polylinePositions->begin(), firstEltPos - firstSlope);
+      polylinePositions->push_back(firstEltPos - firstSlope);
+      for (size_t j = 0; j < pathSize; j++) {
+        polylinePositions->push_back(meshPositions[path[j]]);
+      }
+      polylinePositions->push_back(lastEltPos + lastSlope);
+    }
   }
 
-  // Update or create a vertex object for the positions/indices.
+  // Update or create a vertex object for the positions. Swapping hands the previous frame's array
+  // back as scratch for the next update.
   auto renderingComponentPtr = GetComponentPtr<RenderingComponent>();
   if (renderingComponentPtr != nullptr) {
-    // Update the vertex object
-    GetComponentPtr<RenderingComponent>()->GetVertexObjectPtr()->UpdatePositions(
-        std::move(polylinePositions));
-    GetComponentPtr<RenderingComponent>()->GetVertexObjectPtr()->UpdateIndices(
-        std::move(polyLineIndices));
+    renderingComponentPtr->GetVertexObjectPtr()->SwapPositions(positions_scratch_);
   } else {
-    // Create a new vertex object for the polyline
+    // Create a new vertex object for the polylines
     std::shared_ptr<VertexObject> polylineMesh = std::make_shared<VertexObject>();
-    polylineMesh->UpdatePositions(std::move(polylinePositions));
-    polylineMesh->UpdateIndices(std::move(polyLineIndices));
-
-    CreateComponent<RenderingComponent>(std::move(polylineMesh));
+    polylineMesh->SwapPositions(positions_scratch_);
+    renderingComponentPtr = &CreateComponent<RenderingComponent>(std::move(polylineMesh));
   }
+  renderingComponentPtr->SetDrawRanges(firsts, counts);
 }
+
 void PolylineNode::SetMaterial(const std::shared_ptr<Material>& material) {
   auto materialComponentPtr = GetComponentPtr<MaterialComponent>();
   if (materialComponentPtr != nullptr) {
@@ -8,45 +8,73 @@
 
 namespace GLOO {
 /**
- * Struct defining a polyline with a path, that can also be a loop.
- * A polyline with a loop won't have any of its path indices duplicated,
- * but its first element and last element are connected.
+ * Struct defining a set of polylines, each with a path that can also be a loop.
+ * Paths are stored back to back in one index array: the path of polyline i is
+ * indices[offsets[i]] ... indices[offsets[i + 1] - 1]. A polyline with a loop won't have any of
+ * its path indices duplicated, but its first element and last element are connected.
+ * Clear() keeps the arrays' capacity, so sets rebuilt every frame stop allocating once grown.
  */
-struct Polyline {
-  std::vector<size_t> path;
-  bool is_loop;
+struct PolylineSet {
+  std::vector<uint32_t> offsets{0};
+  std::vector<uint32_t> indices;
+  std::vector<uint8_t> is_loop;
+
+  size_t GetNumPolylines() const {
+    return is_loop.size();
+  }
+  size_t GetPathSize(size_t polyline) const {
+    return offsets[polyline + 1] - offsets[polyline];
+  }
+  const uint32_t* GetPath(size_t polyline) const {
+    return indices.data() + offsets[polyline];
+  }
+  // Ends the current polyline, made of the indices added since the previous one ended.
+  void EndPolyline(bool loop) {
+    offsets.push_back(static_cast<uint32_t>(indices.size()));
+    is_loop.push_back(loop);
+  }
+  void Clear() {
+    offsets.resize(1);
+    indices.clear();
+    is_loop.clear();
+  }
 };
 
 /**
- * Class representing a node that renders a single polyline.
+ * Class representing a node that renders a set of polylines with a single (multi-)draw call.
+ * The node is meant to be kept around and updated with SetPolylines; its CPU and GPU buffers keep
+ * their capacity between updates, so rebuilding the polylines every frame doesn't reallocate.
  */
 class PolylineNode : public SceneNode {
  public:
   /**
-   * Creates a polyline node from a polyline and a mesh.
+   * Creates a polyline node from a set of polylines and a mesh.
    *
-   * @param polyline The polyline to render.
+   * @param polylines The polylines to render.
    * @param meshPositions The positions of the mesh vertices.
    * @param material The material to use for rendering. If nullptr, a default
    * material will be used.
    * @param shader The shader to use for rendering. If nullptr, a default
    * shader will be used.
    */
-  PolylineNode(const Polyline& polyline, const PositionArray& meshPositions,
+  PolylineNode(const PolylineSet& polylines, const PositionArray& meshPositions,
                const std::shared_ptr<Material>& material = nullptr,
                const std::shared_ptr<ShaderProgram>& shader = nullptr);
 
   /**
-   * Updates rendered polyline with new positions.
-   * @param polyline The polyline to render.
+   * Updates rendered polylines with new positions.
+   * @param polylines The polylines to render.
    * @param meshPositions The positions of the mesh vertices.
    */
-  void SetPolyline(const Polyline& polyline, const PositionArray& meshPositions);
+  void SetPolylines(const PolylineSet& polylines, const PositionArray& meshPositions);
   void SetMaterial(const std::shared_ptr<Material>& material);
   void SetShader(const std::shared_ptr<ShaderProgram>& shader);
 
  private:
-  Polyline polyline_;
+  // Scratch buffers reused across SetPolylines calls
+  std::unique_ptr<PositionArray> positions_scratch_;
+  std::vector<GLint> firsts_scratch_;
+  std::vector<GLsizei> counts_scratch_;
 };
 }  // namespace GLOO
 #endif
\ No newline at end of file
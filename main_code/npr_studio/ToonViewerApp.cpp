@@ -27,11 +27,19 @@
 #include "gloo/lights/AmbientLight.hpp"
 #include "gloo/lights/PointLight.hpp"
 #include "gloo/shaders/PhongShader.hpp"
+#include "gloo/shaders/ShaderRegistry.hpp"
 #include "gloo/shaders/SimpleShader.hpp"
 #include "gloo/shaders/ToneMappingShader.hpp"
 #include "gloo/shaders/ToonShader.hpp"
 
 namespace {
+// Indexed by OutlineMethod
+const char* kOutlineMethodNames[] = {"Standard", "Miter Joins (slow/experimental)",
+                                     "GPU Silhouettes", "Standard (GPU edge classification)",
+                                     "Screen Space", "Screen Space (thick, jump flood)",
+                                     "Inverted Hull (fast preview)"};
+const char* kLightingModeNames[] = {"Single Pass", "Multi Pass", "Deferred"};
+
 void SetAmbientToDiffuse(GLOO::MeshData& mesh_data) {
   // Certain groups do not have an ambient color, so we use their diffuse colors
   // instead.
@@ -124,8 +132,8 @@ ToonViewerApp::ToonViewerApp(const std::string& app_name, glm::ivec2 window_size
   illumination_color_ = {1, 1, 1};
   shadow_color_ = {.1, .1, .1};
   outline_color_ = {1, 1, 1};
-  toon_shader_ = std::make_shared<ToonShader>();
-  tone_mapping_shader_ = std::make_shared<ToneMappingShader>();
+  toon_shader_ = GetSharedShader<ToonShader>();
+  tone_mapping_shader_ = GetSharedShader<ToneMappingShader>();
   shading_type_ = ToonShadingType::TONE_MAPPING;
 }
 
@@ -145,8 +153,6 @@ void ToonViewerApp::SetupScene() {
   sun_node_ = sun.get();
   root.AddChild(std::move(sun));
 
-  // Create shader instance
-  auto shader = std::make_shared<ToneMappingShader>();
   // Load and set up the scene OBJ if we have a specified model file.
   // If not, load up a basic sphere.
   if (model_filename_ != "") {
@@ -212,6 +218,7 @@ void ToonViewerApp::UpdateSilhouetteStatus() {
   for (auto node : outline_nodes_) {
     node->SetSilhouetteStatus(show_silhouette_);
   }
+  UpdateScreenOutlines();
 }
 
 void ToonViewerApp::UpdateCreaseStatus() {
@@ -219,6 +226,7 @@ void ToonViewerApp::UpdateCreaseStatus() {
   for (auto node : outline_nodes_) {
     node->SetCreaseStatus(show_crease_);
   }
+  UpdateScreenOutlines();
 }
 
 void ToonViewerApp::UpdateBorderStatus() {
@@ -232,19 +240,40 @@ void ToonViewerApp::UpdateCreaseThreshold() {
   for (auto node : outline_nodes_) {
     node->SetCreaseThreshold(crease_threshold_);
   }
+  UpdateScreenOutlines();
 }
 
 void ToonViewerApp::UpdateOutlineThickness() {
   for (auto node : outline_nodes_) {
     node->SetOutlineThickness(outline_thickness_);
   }
+  UpdateScreenOutlines();
 }
 
 void ToonViewerApp::UpdateOutlineMethod() {
-  OutlineMethod outlineMethod = use_miter_joins_ ? OutlineMethod::MITER : OutlineMethod::STANDARD;
+  OutlineMethod outlineMethod = static_cast<OutlineMethod>(outline_method_);
   for (auto node : outline_nodes_) {
     node->SetOutlineMethod(outlineMethod);
   }
+  UpdateScreenOutlines();
+}
+
+void ToonViewerApp::UpdateScreenOutlines() {
+  if (outline_method_ == OutlineMethod::SCREEN_SPACE) {
+    SetScreenOutlineMode(ScreenOutlineMode::EdgeDetection);
+  } else if (outline_method_ == OutlineMethod::SCREEN_SPACE_JUMP_FLOOD) {
+    SetScreenOutlineMode(ScreenOutlineMode::JumpFlood);
+  } else {
+    SetScreenOutlineMode(ScreenOutlineMode::None);
+  }
+  // Depth edges stand in for silhouettes and normal edges for creases
+  ScreenOutlineStyle style;
+  style.color = vectorToVec3(outline_color_);
+  style.thickness = outline_thickness_;
+  style.silhouettes = show_silhouette_;
+  style.creases = show_crease_;
+  style.cos_crease_threshold = glm::cos(glm::radians(crease_threshold_));
+  SetScreenOutlineStyle(style);
 }
 
 void ToonViewerApp::UpdatePerformanceModeStatus() {
@@ -253,6 +282,12 @@ void ToonViewerApp::UpdatePerformanceModeStatus() {
   });
 }
 
+void ToonViewerApp::UpdateSilhouetteCacheStatus() {
+  ApplyFuncToOutlineNodes([this](OutlineNode* node) {
+    node->SetSilhouetteCacheStatus(this->enable_silhouette_cache_);
+  });
+}
+
 void ToonViewerApp::UpdateMeshVisibility() {
   for (auto node : outline_nodes_) {
     node->SetMeshVisibility(show_mesh_);
@@ -275,6 +310,7 @@ void ToonViewerApp::SetOutlineColor(const glm::vec3& color) {
   for (auto node : outline_nodes_) {
     node->SetOutlineColor(color);
   }
+  UpdateScreenOutlines();
 }
 
 void ToonViewerApp::UpdateDiffuseIntensity() {
@@ -399,11 +435,13 @@ void ToonViewerApp::SaveRenderSettings(const std::string filename, const bool& i
     // Outlines Command - records information about outlines
     if (includeOutlineInfo) {
       file << "outlines\n";
-      file << "miter"
-           << " " << use_miter_joins_ << "\n";
+      file << "method"
+           << " " << outline_method_ << "\n";
       // TODO: Include performance mode info?
       file << "sil"
            << " " << show_silhouette_ << "\n";
+      file << "sil_cache"
+           << " " << enable_silhouette_cache_ << "\n";
       file << "crease"
            << " " << show_crease_ << "\n";
       file << "border"
@@ -517,12 +555,22 @@ void ToonViewerApp::LoadRenderSettings(const std::string filename) {
           std::vector<std::string> tokens = Split(line, ' ');
           std::string command = tokens[0];
           std::string value = tokens[1];
-          if (command == "miter") {
-            use_miter_joins_ = std::stoi(value);
+          if (command == "method") {
+            // Unknown methods (e.g. from a newer preset) fall back to standard outlines
+            int method = std::stoi(value);
+            bool known = method >= 0 && method < IM_ARRAYSIZE(kOutlineMethodNames);
+            outline_method_ = known ? method : OutlineMethod::STANDARD;
+            UpdateOutlineMethod();
+          } else if (command == "miter") {
+            // Presets from before outline methods were selectable only toggle miter joins
+            outline_method_ = std::stoi(value) ? OutlineMethod::MITER : OutlineMethod::STANDARD;
             UpdateOutlineMethod();
           } else if (command == "sil") {
             show_silhouette_ = std::stoi(value);
             UpdateSilhouetteStatus();
+          } else if (command == "sil_cache") {
+            enable_silhouette_cache_ = std::stoi(value);
+            UpdateSilhouetteCacheStatus();
           } else if (command == "crease") {
             show_crease_ = std::stoi(value);
             UpdateCreaseStatus();
@@ -599,6 +647,7 @@ void ToonViewerApp::PushAllGUIValues() {
   UpdateOutlineThickness();
   UpdateOutlineMethod();
   UpdatePerformanceModeStatus();
+  UpdateSilhouetteCacheStatus();
   UpdateMeshVisibility();
   SetIlluminatedColor(vectorToVec3(illumination_color_));
   SetShadowColor(vectorToVec3(shadow_color_));
@@ -644,6 +693,20 @@ void ToonViewerApp::DrawGUI() {
     if (ImGui::SliderFloat("Light Radius", &point_light_radius_, 0, 30, "%.2f")) {
       sun_node_->SetRadius(point_light_radius_);
     }
+    ImGui::Separator();
+
+    if (ImGui::Combo("Lighting", &lighting_mode_, kLightingModeNames,
+                     IM_ARRAYSIZE(kLightingModeNames))) {
+      SetLightingMode(static_cast<LightingMode>(lighting_mode_));
+    }
+    if (ImGui::IsItemHovered()) {
+      ImGui::BeginTooltip();
+      ImGui::Text(
+          "Single Pass shades up to 8 lights per pass, but only one of them casts shadows.\nMulti "
+          "Pass shades every light in its own pass.\nDeferred shades toon and tone mapped surfaces "
+          "once per pixel from a G-buffer, without shadows.");
+      ImGui::EndTooltip();
+    }
   }
   // ImGui::SetNextItemOpen(true, ImGuiCond_Once);
   if (ImGui::CollapsingHeader("Shader Controls:")) {
@@ -687,18 +750,40 @@ void ToonViewerApp::DrawGUI() {
   // Checkboxes for toggling edge type displays
   // ImGui::SetNextItemOpen(true, ImGuiCond_Once);
   if (ImGui::CollapsingHeader("Edge Controls:")) {
-    if (ImGui::Checkbox("Use Miter Join Method (slow/experimental)", &use_miter_joins_)) {
+    if (ImGui::Combo("Outline Method", &outline_method_, kOutlineMethodNames,
+                     IM_ARRAYSIZE(kOutlineMethodNames))) {
       UpdateOutlineMethod();
     }
+    if (ImGui::IsItemHovered()) {
+      ImGui::BeginTooltip();
+      ImGui::Text(
+          "GPU Silhouettes finds silhouettes in a geometry shader, and Standard (GPU edge "
+          "classification) picks the visible edges of every type on the GPU, so orbiting costs no "
+          "CPU edge work.\nScreen Space finds outlines in the rendered depth and normals, at a "
+          "fixed cost per pixel (border edges aren't drawn separately). The jump flood variant "
+          "keeps that cost for wide lines and rounds their joins.\nInverted Hull draws each mesh "
+          "again, pushed out along its normals with front faces culled, so only outer silhouettes "
+          "show and no edges are processed at all.");
+      ImGui::EndTooltip();
+    }
     if (ImGui::Checkbox("Performance Mode", &enable_outline_performance_mode_)) {
       UpdatePerformanceModeStatus();
     }
     if (ImGui::IsItemHovered()) {
       ImGui::BeginTooltip();
       ImGui::Text(
-          "Renders scene without miter joins while camera is moving.\nRequires miter join mode to "
-          "be "
-          "enabled.");
+          "Draws inverted hull outlines instead of Standard or Miter Joins edges while the camera "
+          "is moving.");
+      ImGui::EndTooltip();
+    }
+    if (ImGui::Checkbox("Cache Silhouettes by View", &enable_silhouette_cache_)) {
+      UpdateSilhouetteCacheStatus();
+    }
+    if (ImGui::IsItemHovered()) {
+      ImGui::BeginTooltip();
+      ImGui::Text(
+          "Reuses silhouettes of previously seen view directions.\nSpeeds up repeat views and "
+          "turntables, silhouettes snap to ~1.5 degree steps.");
       ImGui::EndTooltip();
     }
     ImGui::Separator();
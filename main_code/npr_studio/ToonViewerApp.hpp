@@ -27,7 +27,10 @@ class ToonViewerApp : public Application {
   void UpdateCreaseThreshold();
   void UpdateOutlineThickness();
   void UpdateOutlineMethod();
+  // Pushes the outline method and style to the renderer's screen space outlines
+  void UpdateScreenOutlines();
   void UpdatePerformanceModeStatus();
+  void UpdateSilhouetteCacheStatus();
   void UpdateMeshVisibility();
   void SetIlluminatedColor(const glm::vec3& color);
   void SetShadowColor(const glm::vec3& color);
@@ -63,9 +66,12 @@ class ToonViewerApp : public Application {
   bool show_silhouette_ = true;
   bool show_crease_ = true;
   bool show_border_ = true;
-  bool use_miter_joins_ = false;
+  int outline_method_ = OutlineMethod::STANDARD;  // OutlineMethod, as an int for the GUI combo
+  // LightingMode, as an int for the GUI combo
+  int lighting_mode_ = static_cast<int>(LightingMode::MultiPass);
   bool show_mesh_ = true;
   bool enable_outline_performance_mode_ = false;
+  bool enable_silhouette_cache_ = false;
   // Control for getting screenshots from renderer
   // TODO do this in a less hacky way (do rendering to a texture?)
   int renderingImageCountdown = -1;